@@ -9,7 +9,8 @@ rv::Result rv_main()
 
 	rv::Engine engine;
 	rv_rif(rv::Engine::Create(engine));
-	rv::EventListener threadListener(engine.graphics.thread);
+	rv::EventListener threadListener;
+	threadListener.Listen<rv::FailedResult>(engine.graphics.thread);
 
 	rv::Window& window = engine.graphics.CreateWindowRenderer("Rave Window", rv::Size(800, 500), rv::RV_WINDOW_RESIZEABLE);
 
@@ -18,6 +19,7 @@ rv::Result rv_main()
 	const auto& size = window.Size();
 	window.SetTitle(rv::str16(size.width, " x ", size.height));
 	auto prev = size;
+	std::vector<rv::Event> events;
 	while (window.Open())
 	{
 		engine.graphics.thread.RenderSingleThreaded();
@@ -26,7 +28,9 @@ rv::Result rv_main()
 			prev = size;
 			window.SetTitle(rv::str16(size.width, " x ", size.height));
 		}
-		while (rv::Event e = threadListener.GetEvent())
+		events.clear();
+		threadListener.DrainEvents(events);
+		for (const rv::Event& e : events)
 			if (e.IsType<rv::FailedResult>())
 				return e.Get<rv::FailedResult>().result;
 		if constexpr (rv::DebugMessenger::enabled)
@@ -0,0 +1,67 @@
+#include "Benchmark/source/Benchmark.h"
+#include "Engine/Utility/Queue.h"
+#include <array>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+	template<size_t S>
+	struct Payload
+	{
+		std::array<rv::byte, S> bytes{};
+	};
+
+	// Pushes batches of entries and pops them all again, like a frame's worth of events. Returns entries per second
+	template<rv::BlockAllocator A, size_t S>
+	double push_pop(size_t batches, size_t batchSize)
+	{
+		rv::Queue<rv::EmptyInfo, A> queue;
+		const Payload<S> payload;
+		size_t popped = 0;
+		const double seconds = bench::measure([&]()
+			{
+				for (size_t batch = 0; batch < batches; ++batch)
+				{
+					for (size_t i = 0; i < batchSize; ++i)
+						queue.PushEntry(rv::EmptyInfo(), payload);
+					while (auto* header = queue.GetHeader())
+					{
+						++popped;
+						rv::Queue<rv::EmptyInfo, A>::Release(header);
+					}
+				}
+			}
+		);
+		bench::keep(popped);
+		return (double)(batches * batchSize) / seconds;
+	}
+
+	template<size_t S>
+	void compare(size_t batches, size_t batchSize)
+	{
+		// warm the slab caches up, so chunk allocation isn't part of the measurement
+		push_pop<rv::SlabAllocator, S>(1, batchSize);
+
+		const double heap = push_pop<rv::HeapAllocator, S>(batches, batchSize);
+		const double slab = push_pop<rv::SlabAllocator, S>(batches, batchSize);
+		std::cout << std::setw(6) << S << " B" << std::setw(8) << batchSize
+			<< std::setw(14) << heap / 1e6 << std::setw(14) << slab / 1e6
+			<< std::setw(10) << slab / heap << "x\n";
+	}
+}
+
+bool bench::allocator_benchmark()
+{
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "payload   batch    heap Mops/s   slab Mops/s   speedup\n";
+	for (size_t batchSize : { 16, 1024, 16384 })
+	{
+		const size_t batches = (1 << 22) / batchSize;
+		compare<16>(batches, batchSize);
+		compare<64>(batches, batchSize);
+		compare<256>(batches, batchSize);
+		compare<1024>(batches, batchSize);
+	}
+	return true;
+}
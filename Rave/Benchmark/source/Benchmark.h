@@ -0,0 +1,36 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+
+/*
+	Microbenchmarks for the engine's hot paths, every one compares the current implementation against the one it replaced.
+	Build them in Release, debug builds measure the debug runtime more than the code.
+*/
+namespace bench
+{
+	// Runs the callable once and returns the time it took in seconds
+	template<typename F>
+	double measure(F&& run)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		run();
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Keeps the compiler from optimising a result away
+	template<typename T>
+	void keep(const T& value)
+	{
+		static volatile const void* sink;
+		sink = &value;
+	}
+
+	// Every benchmark returns false if one of its checks failed
+
+	// Queue push/pop throughput with the slab allocator against one heap allocation per entry
+	bool allocator_benchmark();
+	// Producer threads posting to one consumer through the lock-free queue against the mutex protected queue it replaced
+	bool contention_benchmark();
+	// XXH3 known answer vectors, and XXH3 throughput against FNV-1a from 8 B to 64 MiB
+	bool hash_benchmark();
+}
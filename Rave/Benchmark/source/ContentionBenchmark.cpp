@@ -0,0 +1,121 @@
+#include "Benchmark/source/Benchmark.h"
+#include "Engine/Utility/BroadcastQueue.h"
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	struct Payload
+	{
+		rv::u64 values[4] = {};
+	};
+
+	// The delivery path events and log records took before the lock-free queue: a heap allocated queue behind a mutex, locked per entry on both ends
+	class MutexQueue
+	{
+	public:
+		void Push(const Payload& payload)
+		{
+			std::lock_guard guard(mutex);
+			queue.PushEntry(rv::EmptyInfo(), payload);
+		}
+
+		size_t Drain()
+		{
+			size_t count = 0;
+			while (true)
+			{
+				rv::Queue<rv::EmptyInfo, rv::HeapAllocator>::Header* header;
+				{
+					std::lock_guard guard(mutex);
+					header = queue.GetHeader();
+				}
+				if (!header)
+					return count;
+				rv::Queue<rv::EmptyInfo, rv::HeapAllocator>::Release(header);
+				++count;
+			}
+		}
+
+	private:
+		rv::Queue<rv::EmptyInfo, rv::HeapAllocator> queue;
+		std::mutex mutex;
+	};
+
+	class LockFreeQueue
+	{
+	public:
+		void Push(const Payload& payload)
+		{
+			auto* header = rv::Queue<rv::EmptyInfo>::MakeEntry(rv::EmptyInfo(), payload);
+			queue.Push(header);
+			rv::Queue<rv::EmptyInfo>::Release(header);
+		}
+
+		size_t Drain()
+		{
+			return queue.Drain([](rv::Queue<rv::EmptyInfo>::Header* header) { rv::Queue<rv::EmptyInfo>::Release(header); });
+		}
+
+	private:
+		rv::BroadcastQueue<rv::EmptyInfo> queue;
+	};
+
+	// Every producer posts its share while a single consumer drains until it has seen them all. Returns entries per second
+	template<typename Q>
+	double contend(size_t producers, size_t total)
+	{
+		Q queue;
+		std::atomic<bool> start = false;
+		const size_t share = total / producers;
+
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < producers; ++i)
+		{
+			threads.emplace_back([&]()
+				{
+					while (!start.load(std::memory_order_acquire))
+						std::this_thread::yield();
+					const Payload payload;
+					for (size_t n = 0; n < share; ++n)
+						queue.Push(payload);
+				}
+			);
+		}
+
+		const double seconds = bench::measure([&]()
+			{
+				start.store(true, std::memory_order_release);
+				for (size_t consumed = 0; consumed < share * producers;)
+				{
+					const size_t drained = queue.Drain();
+					if (drained == 0)
+						std::this_thread::yield();
+					consumed += drained;
+				}
+			}
+		);
+		for (std::thread& thread : threads)
+			thread.join();
+		return (double)(share * producers) / seconds;
+	}
+}
+
+bool bench::contention_benchmark()
+{
+	const size_t total = 1 << 21;
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "producers   mutex Mops/s   lock-free Mops/s   speedup\n";
+	for (size_t producers : { 1, 2, 4, 8, 16, 32 })
+	{
+		const double locked = contend<MutexQueue>(producers, total);
+		const double lockFree = contend<LockFreeQueue>(producers, total);
+		std::cout << std::setw(9) << producers << std::setw(15) << locked / 1e6
+			<< std::setw(19) << lockFree / 1e6 << std::setw(9) << lockFree / locked << "x\n";
+	}
+	return true;
+}
@@ -0,0 +1,125 @@
+#include "Benchmark/source/Benchmark.h"
+#include "Engine/Utility/Hash.h"
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+	struct KnownAnswer
+	{
+		size_t length;
+		rv::u64 hash64;
+		rv::Hash128 hash128;
+	};
+
+	// Reference XXH3 results for pattern(length), every length takes a different path through the hash
+	static constexpr KnownAnswer known_answers[] = {
+		{ 0, 0x2d06800538d394c2ull, { 0x6001c324468d497full, 0x99aa06d3014798d8ull } },
+		{ 1, 0xc44bdff4074eecdbull, { 0xc44bdff4074eecdbull, 0xa6cd5e9392000f6aull } },
+		{ 3, 0xe14090f554a5ea90ull, { 0xe14090f554a5ea90ull, 0x977fcbc0448b49f6ull } },
+		{ 4, 0x2e8d078a566e9749ull, { 0x4ee6926f0426173eull, 0x4e82b36688c5328full } },
+		{ 8, 0xcd1c7f88482fcaefull, { 0x79d85adaeefd615eull, 0x7b4966a681f18d57ull } },
+		{ 16, 0x81e9eb8634460bb9ull, { 0x37286a19cf622308ull, 0x78e8ab538d3acaabull } },
+		{ 17, 0x9998430fd0a655beull, { 0x33bed349ec1c0ce7ull, 0x1ea709ada2b9c32eull } },
+		{ 128, 0x75eca5c5d5594884ull, { 0xe1f0636051ccd2beull, 0x5ac741c59c95d36aull } },
+		{ 129, 0xa05da42e7a4e4667ull, { 0xcfb3fed667226458ull, 0x1240f4d960139642ull } },
+		{ 240, 0x5eb2467c8c9e3969ull, { 0xb2e6947c477a4ab0ull, 0x640a6149838a7599ull } },
+		{ 241, 0x2d431e984c441f15ull, { 0x2d431e984c441f15ull, 0xe817e20e53e42a8cull } },
+		{ 1024, 0xe99def1145f12936ull, { 0xe99def1145f12936ull, 0xdf4c8b9ff9715101ull } },
+		{ 1024 * 1024, 0xa60868b9a5018405ull, { 0xa60868b9a5018405ull, 0x7e34237c007b503eull } },
+	};
+
+	static constexpr rv::u8 pattern_byte(size_t i)
+	{
+		return (rv::u8)((rv::u32)(i * 2654435761u) >> 24);
+	}
+
+	static std::vector<rv::u8> pattern(size_t length)
+	{
+		std::vector<rv::u8> data(length);
+		for (size_t i = 0; i < length; ++i)
+			data[i] = pattern_byte(i);
+		return data;
+	}
+
+	// The lengths up to the first one of the long path are also checked at compile time, which uses the scalar code
+	static constexpr size_t constexpr_length = 241;
+
+	template<size_t L>
+	static constexpr std::array<rv::u8, L> constexpr_pattern()
+	{
+		std::array<rv::u8, L> data{};
+		for (size_t i = 0; i < L; ++i)
+			data[i] = pattern_byte(i);
+		return data;
+	}
+
+	static constexpr auto constexpr_data = constexpr_pattern<constexpr_length>();
+	static_assert(rv::Xxh3::Hash(constexpr_data.data(), 0) == known_answers[0].hash64);
+	static_assert(rv::Xxh3::Hash(constexpr_data.data(), 3) == known_answers[2].hash64);
+	static_assert(rv::Xxh3::Hash(constexpr_data.data(), 17) == known_answers[6].hash64);
+	static_assert(rv::Xxh3::Hash(constexpr_data.data(), 129) == known_answers[8].hash64);
+	static_assert(rv::Xxh3::Hash(constexpr_data.data(), 241) == known_answers[10].hash64);
+	static_assert(rv::Xxh3_128::Hash(constexpr_data.data(), 4) == known_answers[3].hash128);
+	static_assert(rv::Xxh3_128::Hash(constexpr_data.data(), 16) == known_answers[5].hash128);
+	static_assert(rv::Xxh3_128::Hash(constexpr_data.data(), 128) == known_answers[7].hash128);
+	static_assert(rv::Xxh3_128::Hash(constexpr_data.data(), 240) == known_answers[9].hash128);
+
+	static bool check_known_answers()
+	{
+		bool passed = true;
+		for (const KnownAnswer& answer : known_answers)
+		{
+			const std::vector<rv::u8> data = pattern(answer.length);
+			if (rv::Xxh3::Hash(data.data(), data.size()) != answer.hash64)
+			{
+				std::cout << "XXH3-64 mismatch for " << answer.length << " bytes\n";
+				passed = false;
+			}
+			if (rv::Xxh3_128::Hash(data.data(), data.size()) != answer.hash128)
+			{
+				std::cout << "XXH3-128 mismatch for " << answer.length << " bytes\n";
+				passed = false;
+			}
+		}
+		return passed;
+	}
+
+	// Hashes the data repeatedly, at least 256 MiB in total. Returns bytes per second
+	template<typename F>
+	double throughput(const std::vector<rv::u8>& data, F&& hash)
+	{
+		const size_t repeats = std::max<size_t>((size_t)256 * 1024 * 1024 / data.size(), 1);
+		rv::u64 sink = 0;
+		const double seconds = bench::measure([&]()
+			{
+				for (size_t i = 0; i < repeats; ++i)
+					sink ^= hash(data);
+			}
+		);
+		bench::keep(sink);
+		return (double)(repeats * data.size()) / seconds;
+	}
+}
+
+bool bench::hash_benchmark()
+{
+	const bool passed = check_known_answers();
+	std::cout << "known answers " << (passed ? "passed" : "FAILED") << "\n\n";
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "     size   FNV-1a GB/s   XXH3-64 GB/s   XXH3-128 GB/s\n";
+	const size_t KiB = 1024, MiB = 1024 * KiB;
+	for (size_t size : { (size_t)8, (size_t)64, (size_t)512, 4 * KiB, 32 * KiB, 256 * KiB, 2 * MiB, 16 * MiB, 64 * MiB })
+	{
+		const std::vector<rv::u8> data = pattern(size);
+		const double fnv = throughput(data, [](const std::vector<rv::u8>& data) { return rv::hash<rv::u64>(data); });
+		const double xxh3 = throughput(data, [](const std::vector<rv::u8>& data) { return rv::hash<rv::Xxh3>(data); });
+		const double xxh3_128 = throughput(data, [](const std::vector<rv::u8>& data) { return rv::hash<rv::Xxh3_128>(data).low; });
+		std::cout << std::setw(9) << size << std::setw(14) << fnv / 1e9 << std::setw(15) << xxh3 / 1e9 << std::setw(16) << xxh3_128 / 1e9 << "\n";
+	}
+	return passed;
+}
@@ -0,0 +1,53 @@
+#include "Benchmark/source/Benchmark.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+/*
+	Runs the engine's microbenchmarks and prints their results to the console.
+
+	usage: Benchmark [name...]
+	runs every benchmark when no names are given, fails if a benchmark's checks failed.
+*/
+
+struct Benchmark
+{
+	const char* name;
+	bool(*run)();
+};
+
+static constexpr Benchmark benchmarks[] = {
+	{ "allocator", bench::allocator_benchmark },
+	{ "contention", bench::contention_benchmark },
+	{ "hash", bench::hash_benchmark },
+};
+
+int main(int argc, char** argv)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		bool known = false;
+		for (const Benchmark& benchmark : benchmarks)
+			known |= std::strcmp(argv[i], benchmark.name) == 0;
+		if (!known)
+		{
+			std::cerr << "Unknown benchmark \"" << argv[i] << "\"\n";
+			return EXIT_FAILURE;
+		}
+	}
+
+	bool passed = true;
+	for (const Benchmark& benchmark : benchmarks)
+	{
+		bool selected = argc == 1;
+		for (int i = 1; i < argc; ++i)
+			selected |= std::strcmp(argv[i], benchmark.name) == 0;
+		if (!selected)
+			continue;
+
+		std::cout << "== " << benchmark.name << "\n";
+		passed &= benchmark.run();
+		std::cout << "\n";
+	}
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -2,24 +2,28 @@
 #include "Engine/Utility/ResultHandler.h"
 #include "Engine/Utility/Result.h"
 #include "Engine/Utility/Error.h"
-#include "Engine/Graphics/DebugMessenger.h"
+#include "Engine/Utility/Logger.h"
+#include "Engine/Utility/BinaryLogger.h"
 
 rv::Result rv::startup()
 {
-	resultHandler.RegisterResult(global_result);
-	resultHandler.RegisterResult(condition_result);
-	resultHandler.RegisterResult(assertion_result);
-	resultHandler.RegisterResult(file_result);
-	resultHandler.RegisterResult(hr_result);
-	resultHandler.RegisterResult(vkr_result);
-	resultHandler.RegisterResult(vulkan_debug_result);
+	rv_result;
 
-	return success;
+#	ifdef RV_DEBUG_LOGGER
+	// long sessions keep their older log records on disk instead of in memory
+	LogRetention retention;
+	retention.spillFile = "Rave.log.spill";
+	rv_rif(debug.SetRetention(retention));
+#	endif
+
+	return result;
 }
 
 void rv::cleanup()
 {
 	resultHandler.Clear();
+	if constexpr (binlog.enabled)
+		binlog.Dump();
 }
 
 rv::AutoStartupClean::AutoStartupClean()
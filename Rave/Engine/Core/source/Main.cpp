@@ -4,6 +4,8 @@
 #include "Engine/Utility/Types.h"
 #include "Engine/Utility/ResultHandler.h"
 #include "Engine/Utility/String.h"
+#include "Engine/Utility/Logger.h"
+#include "Engine/Utility/BinaryLogger.h"
 #include "Engine/Core/AutoStartupClean.h"
 #include "Engine/Graphics/DebugMessenger.h"
 
@@ -24,6 +26,11 @@ uint to_icon(Severity severity)
 
 void message_box(const wchar_t* title, const wchar_t* message, uint icon = MB_ICONERROR)
 {
+	// every fatal path ends up here, get the pending log output out before the process goes down
+	rv::debug.Flush();
+	if constexpr (rv::binlog.enabled)
+		rv::binlog.Dump();
+
 	int response = MessageBox(nullptr, message, title, icon | MB_RETRYCANCEL);
 
 	if constexpr (resultHandler.enabled)
@@ -32,6 +39,7 @@ void message_box(const wchar_t* title, const wchar_t* message, uint icon = MB_IC
 		std::wostringstream ss;
 
 		Severity maxSeverity = RV_SEVERITY_NULL;
+		const bool aggregating = resultHandler.Aggregating();
 
 		auto queues = resultHandler.GetQueues();
 		for (auto& ref : queues)
@@ -43,6 +51,10 @@ void message_box(const wchar_t* title, const wchar_t* message, uint icon = MB_IC
 			while (auto result = queue.GetResult())
 				results.emplace_back(result);
 
+			// aggregated results are in the statistics, only results queued before aggregation started are listed here
+			if (aggregating && results.empty())
+				continue;
+
 			if (thread == std::this_thread::get_id())
 				detail::str(ss, L"Main thread:\t", results.size(), L" results\n");
 			else
@@ -71,6 +83,13 @@ void message_box(const wchar_t* title, const wchar_t* message, uint icon = MB_IC
 			ss << L"\n\n";
 		}
 
+		if (aggregating)
+		{
+			const Severity statisticSeverity = resultHandler.DumpStatistics(ss);
+			if (maxSeverity < statisticSeverity)
+				maxSeverity = statisticSeverity;
+		}
+
 		if (!queues.empty())
 			MessageBox(nullptr, ss.str().c_str(), L"Queued Result Information", to_icon(maxSeverity) | MB_OK);
 	}
@@ -10,8 +10,6 @@
 
 namespace rv
 {
-	static constexpr Identifier32 vulkan_debug_result = "Vulkan Debug Result";
-
 	struct VulkanDebugMessage
 	{
 		VulkanDebugMessage() = default;
@@ -3,6 +3,7 @@
 #include "Engine/Utility/Result.h"
 #include "Engine/Utility/String.h"
 #include "Engine/Utility/Vector.h"
+#include "Engine/Utility/Event.h"
 #include "Engine/Graphics/Swapchain.h"
 #include <map>
 #include <mutex>
@@ -49,6 +50,16 @@ namespace rv
 		Flags<WindowOptions> options;
 	};
 
+	// Posted by a window when its client area is resized. Only the latest size is kept while the event is pending
+	struct ResizeEvent
+	{
+		ResizeEvent() = default;
+		ResizeEvent(const Size& size, bool minimized) : size(size), minimized(minimized) {}
+
+		Size size;
+		bool minimized = false;
+	};
+
 	class Window
 	{
 	public:
@@ -81,6 +92,8 @@ namespace rv
 		const Point& Position() const;
 		const Size& Size() const;
 
+		EventLogger& Events();
+
 	private:
 		static Win32Class windowClass;
 		static LRESULT CALLBACK StaticWindowSetupProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
@@ -104,6 +117,7 @@ namespace rv
 		utf16_string newTitle;
 		bool updatedTitle = false;
 		std::unique_ptr<std::mutex> mutex;
+		std::unique_ptr<EventLogger> events;
 		bool drawn = false;
 		Swapchain swap;
 		const Device* device = nullptr;
@@ -3,11 +3,9 @@
 #include "Engine/Utility/Logger.h"
 
 #ifdef RV_DEBUG_LOGGER
-static constexpr bool debugLogger = true;
 std::deque<rv::VulkanDebugMessage> rv::DebugMessenger::staticMessages;
 std::mutex rv::DebugMessenger::staticMutex;
 #else
-static constexpr bool debugLogger = false;
 #include <iostream>
 #endif
 
@@ -74,11 +72,6 @@ VkBool32 rv::DebugMessenger::Callback(VkDebugUtilsMessageSeverityFlagBitsEXT sev
 	VulkanDebugMessage message;
 	message.severity = severity;
 	message.message = callbackData ? callbackData->pMessage : "<!> Callback data empty <!>";
-	utf16_string utf16_message;
-
-	if constexpr (resultHandler.enabled || debugLogger)
-		utf16_message = message.message;
-
 	if (data)
 	{
 		DebugMessenger& messenger = *reinterpret_cast<DebugMessenger*>(data);
@@ -92,7 +85,12 @@ VkBool32 rv::DebugMessenger::Callback(VkDebugUtilsMessageSeverityFlagBitsEXT sev
 	}
 
 #ifdef RV_DEBUG_LOGGER
-	debug.Log(utf16_message, Convert(severity));
+	if (debug.Enabled(RV_LOG_CHANNEL_VULKAN, Convert(severity)))
+	{
+		// validation layers repeat the same message every frame, so it's limited per message id rather than per call site
+		const u64 site = callbackData && callbackData->pMessageIdName ? hash<u64>(callbackData->pMessageIdName) : hash<u64>(message.message);
+		debug.LogLimited(site, Convert(severity), [&message]() { return utf16_string(message.message); });
+	}
 #else
 	std::cout << message.message << '\n';
 #endif
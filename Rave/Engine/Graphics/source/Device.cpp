@@ -323,7 +323,7 @@ rv::Result rv::Device::Create(Device& device, const Instance& instance, const De
 			device.graphics = device.GetQueue(device.graphics.family);
 		if (device.compute.family != Optional<u32>::invalid_value)
 			device.compute = device.GetQueue(device.compute.family);
-		rv_logstr(strvalid(u"Created Device \""), device.physical.properties.deviceName, u'\"');
+		rv_logstr_channel(RV_LOG_CHANNEL_DEVICE, RV_SEVERITY_INFO, strvalid(u"Created Device \""), device.physical.properties.deviceName, u'\"');
 	}
 	return result;
 }
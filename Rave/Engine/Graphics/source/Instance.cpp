@@ -162,7 +162,7 @@ rv::Result rv::Instance::Create(Instance& instance, const InstanceExtensions& ex
 	auto debugInfo = DebugMessenger::CreateInfo();
 	createInfo.pNext = &debugInfo;
 #endif
-	rv_log(str16(strvalid(u8"Created instance \""), app.info.pEngineName, u'\"'));
+	rv_logstr_channel(RV_LOG_CHANNEL_GRAPHICS, RV_SEVERITY_INFO, strvalid(u8"Created instance \""), app.info.pEngineName, u'\"');
 
 	return rv_check_vkr_msg(vkCreateInstance(&createInfo, nullptr, &instance.instance), strvalid(u8"Unable to create instance"));
 }
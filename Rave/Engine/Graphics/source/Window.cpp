@@ -112,8 +112,11 @@ rv::WindowDescriptor::WindowDescriptor(utf16_string&& title, WindowOptions optio
 
 rv::Window::Window()
 	:
-	mutex(new std::mutex())
+	mutex(new std::mutex()),
+	events(new EventLogger())
 {
+	// a live resize produces WM_SIZE at message rate, listeners only care about the latest size
+	events->CoalesceEvents<ResizeEvent>();
 }
 
 rv::Window::~Window()
@@ -171,7 +174,7 @@ rv::Result rv::Window::Create(Window& window, const Device& device, Descriptor&&
 	if (window.hwnd)
 		rif_check_last_msg(ShowWindow(window.hwnd, SW_SHOWNORMAL), str16(strvalid(u"Unable to show window \""), window.title, u'\"'));
 
-	rv_log(str16(strvalid(u8"Created window \""), window.title, u'\"'));
+	rv_logstr_channel(RV_LOG_CHANNEL_GRAPHICS, RV_SEVERITY_INFO, strvalid(u8"Created window \""), window.title, u'\"');
 
 	return result;
 }
@@ -279,6 +282,11 @@ const rv::Size& rv::Window::Size() const
 	return size;
 }
 
+rv::EventLogger& rv::Window::Events()
+{
+	return *events;
+}
+
 LRESULT rv::Window::StaticWindowSetupProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
 	if (msg == WM_CREATE)
@@ -346,6 +354,7 @@ LRESULT rv::Window::WindowProc(HWND, UINT msg, WPARAM wParam, LPARAM lParam)
 				minimized = false;
 				SetResult(Swapchain::Create(swap, *device, *this));
 			}
+			events->PostEvent(ResizeEvent(size, minimized));
 		}
 		return 0;
 	}
@@ -7,10 +7,12 @@
 #include "Engine/Utility/Result.h"
 #include "Engine/Utility/Concepts.h"
 #include "Engine/Utility/Hash.h"
+#include "Engine/Utility/Hasher.h"
 #include "Engine/Utility/Identifier.h"
 #include "Engine/Utility/Error.h"
 #include "Engine/Utility/TimeStamp.h"
 #include "Engine/Utility/Event.h"
+#include "Engine/Utility/Visit.h"
 #include "Engine/Utility/Logger.h"
 #include "Engine/Utility/ResultHandler.h"
 #include "Engine/Utility/Vector.h"
@@ -0,0 +1,45 @@
+#pragma once
+#include "Engine/Utility/Types.h"
+#include <concepts>
+#include <new>
+
+namespace rv
+{
+	template<typename A>
+	concept BlockAllocator = requires(size_t size, size_t alignment, void* block)
+	{
+		{ A::Allocate(size, alignment) } -> std::same_as<void*>;
+		A::Free(block, size, alignment);
+	};
+
+	/*
+		Allocates every block straight from the global heap.
+		This is the behaviour Queue had before it became allocator aware.
+	*/
+	struct HeapAllocator
+	{
+		static void* Allocate(size_t size, size_t alignment);
+		static void Free(void* block, size_t size, size_t alignment);
+	};
+
+	/*
+		Chunked slab allocator with power of two size classes.
+		Every thread keeps a cache of free blocks per size class, so allocating and freeing is a pointer swap.
+		Caches that grow too large hand a batch of blocks back to a shared pool, where other threads can pick them up.
+		Blocks that are too large or too strictly aligned for a size class are forwarded to the HeapAllocator.
+	*/
+	struct SlabAllocator
+	{
+		static constexpr size_t min_block_size = 32;
+		static constexpr size_t max_block_size = 2048;
+		static constexpr size_t block_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+		static constexpr size_t chunk_size = 64 * 1024;
+
+		static void* Allocate(size_t size, size_t alignment);
+		static void Free(void* block, size_t size, size_t alignment);
+
+		static constexpr bool Pooled(size_t size, size_t alignment) { return size <= max_block_size && alignment <= block_alignment; }
+	};
+
+	using DefaultAllocator = SlabAllocator;
+}
\ No newline at end of file
@@ -1,88 +1,162 @@
 #pragma once
 #include "Engine/Utility/Types.h"
-#include <typeinfo>
+#include "Engine/Utility/TypeId.h"
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace rv
 {
-	class Any
+	/*
+		Type erased value.
+		Values of at most C bytes with an alignment of at most A that don't throw when moved are stored inline, larger ones on the heap.
+		Trivially copyable values are relocated with a memcpy when the Any is moved.
+		Only a copyable Any can be copied, it only accepts values with a copy constructor, so a copy never silently comes out empty.
+	*/
+	template<size_t C = 64, size_t A = alignof(std::max_align_t), bool copyable = false>
+	class BasicAny
 	{
 	public:
-		Any() : m_data(nullptr) {}
-		Any(const Any&) = delete;
-		Any(Any&& rhs) noexcept : m_data(rhs.m_data) { rhs.m_data = nullptr; }
-		~Any() { Clear(); }
+		static constexpr size_t inline_capacity = C;
+		static constexpr size_t inline_alignment = A;
+		static constexpr bool is_copyable = copyable;
 
-		template<typename T> Any(const T& value) : m_data(&(new Entry<T>(value))->header) {}
-		template<typename T> Any(T&& value) : m_data(&(new Entry<T>(std::move(value)))->header) {}
+		template<typename T>
+		static constexpr bool fits_inline = sizeof(T) <= C && alignof(T) <= A && std::is_nothrow_move_constructible_v<T>;
+
+		BasicAny() = default;
+		BasicAny(const BasicAny& rhs) requires copyable { CopyFrom(rhs); }
+		BasicAny(BasicAny&& rhs) noexcept { MoveFrom(rhs); }
+		~BasicAny() { Clear(); }
+
+		template<typename T>
+		requires (!std::is_same_v<std::remove_cvref_t<T>, BasicAny>)
+		BasicAny(T&& value) { Emplace<std::remove_cvref_t<T>>(std::forward<T>(value)); }
 
-		Any& operator=(const Any&) = delete;
-		Any& operator=(Any&& rhs) noexcept { Clear(); m_data = rhs.m_data; rhs.m_data = nullptr; return *this; }
+		BasicAny& operator=(const BasicAny& rhs) requires copyable { if (this != &rhs) { Clear(); CopyFrom(rhs); } return *this; }
+		BasicAny& operator=(BasicAny&& rhs) noexcept { if (this != &rhs) { Clear(); MoveFrom(rhs); } return *this; }
 
-		operator bool() const { return Empty(); }
-		bool Empty() const { return m_data; }
+		template<typename T, typename... Args>
+		T& Emplace(Args&&... args)
+		{
+			static_assert(!copyable || std::is_copy_constructible_v<T>, "A copyable Any can only hold values with a copy constructor");
+			Clear();
+			T* object;
+			if constexpr (fits_inline<T>)
+				object = new (storage.buffer) T(std::forward<Args>(args)...);
+			else
+				object = static_cast<T*>(storage.pointer = new T(std::forward<Args>(args)...));
+			operations = operations_of<T>();
+			return *object;
+		}
 
+		operator bool() const { return !Empty(); }
+		bool Empty() const { return !operations; }
+
+		// The type_id of the value, 0 if the Any is empty
+		u64 Type() const { return operations ? operations->type : 0; }
 		template<typename T>
-		bool IsType() const { return m_data ? (m_data->type == typeid(T).hash_code()) : false; }
+		bool IsType() const { return operations ? (operations->type == type_id<T>()) : false; }
 
 		template<typename T>
-		T& Get() { return *m_data->data<T>(); }
+		T& Get() { return *static_cast<T*>(Data()); }
 		template<typename T>
-		const T& Get() const { return *m_data->data<T>(); }
+		const T& Get() const { return *static_cast<const T*>(Data()); }
 
-		void* Data() { return m_data->data(); }
-		const void* Data() const { return m_data->data(); }
+		void* Data() { return operations ? (operations->heap ? storage.pointer : storage.buffer) : nullptr; }
+		const void* Data() const { return operations ? (operations->heap ? storage.pointer : storage.buffer) : nullptr; }
 
-		void Clear() { if (m_data) delete m_data; }
+		void Clear()
+		{
+			if (!operations)
+				return;
+			if (operations->heap)
+				operations->destroy_heap(storage.pointer);
+			else if (operations->destroy)
+				operations->destroy(storage.buffer);
+			operations = nullptr;
+		}
 
 	private:
-		typedef void(*Destructor)(void*);
-		template<typename T>
-		static void make_destructor(void* object)
+		struct Operations
 		{
-			if (object)
-				reinterpret_cast<T*>(object)->~T();
-		}
+			u64 type;
+			bool heap;
+			// nullptr if the value doesn't need to be destroyed
+			void(*destroy)(void* object);
+			void(*destroy_heap)(void* object);
+			// move constructs the value at to and destroys the one at from, nullptr if a memcpy does the same
+			void(*relocate)(void* from, void* to);
+			// copy constructs the value at to, or allocates a copy if it's stored on the heap. nullptr unless the Any is copyable
+			void*(*copy)(const void* from, void* to);
+		};
 
-		struct Header
+		template<typename T>
+		static constexpr Operations make_operations()
 		{
-			Header() = default;
-			~Header()
+			Operations ops{};
+			ops.type = type_id<T>();
+			ops.heap = !fits_inline<T>;
+			if constexpr (!std::is_trivially_destructible_v<T>)
+				ops.destroy = [](void* object) { static_cast<T*>(object)->~T(); };
+			ops.destroy_heap = [](void* object) { delete static_cast<T*>(object); };
+			if constexpr (!std::is_trivially_copyable_v<T>)
+				ops.relocate = [](void* from, void* to) { new (to) T(std::move(*static_cast<T*>(from))); static_cast<T*>(from)->~T(); };
+			if constexpr (copyable)
 			{
-				if (destructor)
-					destructor(data());
+				if constexpr (fits_inline<T>)
+					ops.copy = [](const void* from, void* to) -> void* { return new (to) T(*static_cast<const T*>(from)); };
+				else
+					ops.copy = [](const void* from, void*) -> void* { return new T(*static_cast<const T*>(from)); };
 			}
+			return ops;
+		}
 
-			template<typename T = void>
-			T* data() { return reinterpret_cast<T*>(reinterpret_cast<byte*>(this) + data_offset); }
-			template<typename T = void>
-			const T* data() const { return reinterpret_cast<const T*>(reinterpret_cast<const byte*>(this) + data_offset); }
-
-			Destructor destructor = nullptr;
-			size_t data_offset = 0;
-			size_t type = 0;
-		};
 		template<typename T>
-		struct Entry
+		static const Operations* operations_of()
 		{
-			Entry() = default;
-			Entry(const T& value) : data(value) 
-			{
-				header.type = typeid(T).hash_code();
-				header.data_offset = offsetof(Entry<T>, data) - offsetof(Entry<T>, header);
-				if constexpr (std::is_class_v<T>)
-					header.destructor = make_destructor<T>;
-			}
-			Entry(T&& value) : data(std::move(value))
-			{
-				header.type = typeid(T).hash_code();
-				header.data_offset = offsetof(Entry<T>, data) - offsetof(Entry<T>, header);
-				if constexpr (std::is_class_v<T>)
-					header.destructor = make_destructor<T>;
-			}
-			Header header;
-			T data;
+			static constexpr Operations operations = make_operations<T>();
+			return &operations;
+		}
+
+		void MoveFrom(BasicAny& rhs)
+		{
+			operations = rhs.operations;
+			if (!operations)
+				return;
+			if (operations->heap)
+				storage.pointer = rhs.storage.pointer;
+			else if (operations->relocate)
+				operations->relocate(rhs.storage.buffer, storage.buffer);
+			else
+				std::memcpy(storage.buffer, rhs.storage.buffer, C);
+			rhs.operations = nullptr;
+		}
+
+		void CopyFrom(const BasicAny& rhs)
+		{
+			if (!rhs.operations)
+				return;
+			if (rhs.operations->heap)
+				storage.pointer = rhs.operations->copy(rhs.storage.pointer, nullptr);
+			else
+				rhs.operations->copy(rhs.storage.buffer, storage.buffer);
+			operations = rhs.operations;
+		}
+
+	private:
+		union Storage
+		{
+			alignas(A) byte buffer[C];
+			void* pointer;
 		};
 
-		Header* m_data;
+		Storage storage;
+		const Operations* operations = nullptr;
 	};
+
+	typedef BasicAny<> Any;
+	typedef BasicAny<64, alignof(std::max_align_t), true> CopyableAny;
 }
\ No newline at end of file
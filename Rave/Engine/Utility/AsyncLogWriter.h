@@ -0,0 +1,78 @@
+#pragma once
+#include "Engine/Utility/Types.h"
+#include "Engine/Utility/Result.h"
+#include "Engine/Utility/String.h"
+#include "Engine/Utility/RingBuffer.h"
+#include "Engine/Utility/TimeStamp.h"
+#include "Engine/Utility/LogSink.h"
+#include <atomic>
+#include <condition_variable>
+#include <initializer_list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rv
+{
+	/*
+		Moves log output off the calling thread.
+		Write only copies the message, its severity and the time into a record in a lock-free ring buffer,
+		short messages are stored inline in the record so the calling thread doesn't allocate,
+		a background thread does the timestamp breakdown, severity tagging and output to the sinks.
+		Write never blocks: when the ring is full the message is dropped and the writer reports how many were lost.
+	*/
+	class AsyncLogWriter
+	{
+	public:
+		static constexpr size_t capacity = 4096;
+
+		AsyncLogWriter(std::initializer_list<LogSink*> sinks);
+		AsyncLogWriter(const AsyncLogWriter&) = delete;
+		~AsyncLogWriter();
+
+		AsyncLogWriter& operator= (const AsyncLogWriter&) = delete;
+
+		// Can be called from any thread, returns false if the message was dropped
+		bool Write(const utf16_string& message, Severity severity);
+		// Blocks until every message written before the call has been output, used on fatal paths before the process goes down
+		void Flush();
+
+		u64 Dropped() const;
+
+	private:
+		struct Record
+		{
+			// messages up to this many characters fit in the record, only longer ones are copied to the heap
+			static constexpr size_t inline_length = 96;
+
+			Record() = default;
+			Record(const utf16_string& message, Severity severity);
+
+			utf16_string Message();
+
+			Severity severity = RV_SEVERITY_NULL;
+			TimeStamp stamp;
+			size_t length = 0;
+			char16_t text[inline_length];
+			utf16_string overflow;
+		};
+
+		void Run();
+		void Output(Record& record);
+		void Wake();
+
+	private:
+		RingBuffer<Record, capacity> ring;
+		std::vector<LogSink*> sinks;
+		// reused for every line by the writer thread
+		std::string line;
+		std::atomic<size_t> outputCount = 0;
+		std::atomic<u64> dropped = 0;
+		std::atomic<bool> waiting = false;
+		bool running = true;
+		std::mutex mutex;
+		std::condition_variable signal;
+		std::condition_variable flushed;
+		std::thread thread;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include "Engine/Utility/Types.h"
+
+/*
+	Layout of a binary log dump, shared by the BinaryLogger and the LogDecoder.
+	Only depends on Types.h, so tools can read dumps without linking the engine.
+
+	file:		u32 magic, u32 version, followed by blocks until the end of the file
+	block:		u8 block type, u32 payload size, payload
+
+	clock:		i64 steady ticks, i64 system time in nanoseconds since the epoch, i64 tick period numerator, i64 tick period denominator
+				maps the steady ticks of the records that follow on wall clock time
+	site:		u32 id, u32 severity, u32 line, u32 file size, file, u32 format size, format
+				one per call site, written before the first records that refer to it
+	records:	u64 thread id, followed by records until the end of the block
+	dropped:	u64 thread id, u64 record count
+				records the thread logged since the previous dump but couldn't buffer, thread id 0 counts records of exiting threads
+
+	record:		u32 site id, i64 steady ticks, u8 argument count, arguments
+	argument:	u8 argument type, value
+				integers, floats and characters are stored as 8 byte values, bools as 1 byte
+				strings are stored as a u32 size in bytes followed by the code units
+
+	All values are little endian, as written by the platforms the engine runs on.
+*/
+
+namespace rv
+{
+	static constexpr u32 binary_log_magic = 0x4C425652; // "RVBL"
+	static constexpr u32 binary_log_version = 1;
+
+	enum BinaryLogBlock : u8
+	{
+		RV_BINARY_LOG_CLOCK		= 0,
+		RV_BINARY_LOG_SITE		= 1,
+		RV_BINARY_LOG_RECORDS	= 2,
+		RV_BINARY_LOG_DROPPED	= 3,
+	};
+
+	enum BinaryLogArgument : u8
+	{
+		RV_BINARY_LOG_SIGNED	= 0,
+		RV_BINARY_LOG_UNSIGNED	= 1,
+		RV_BINARY_LOG_FLOAT		= 2,
+		RV_BINARY_LOG_BOOL		= 3,
+		RV_BINARY_LOG_CHAR		= 4,
+		RV_BINARY_LOG_UTF8		= 5,
+		RV_BINARY_LOG_UTF16		= 6,
+		RV_BINARY_LOG_UTF32		= 7,
+	};
+}
\ No newline at end of file
@@ -0,0 +1,263 @@
+#pragma once
+#include "Engine/Utility/Types.h"
+#include "Engine/Utility/Result.h"
+#include "Engine/Utility/BinaryLogFormat.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace rv
+{
+	/*
+		Static description of a binary log call site, created once by the rv_binlog macros.
+		Records only refer to their site by id, the format string is written to the dump once.
+	*/
+	class BinaryLogSite
+	{
+	public:
+		BinaryLogSite(const char* format, Severity severity, const char* file, u32 line);
+		BinaryLogSite(const BinaryLogSite&) = delete;
+
+		BinaryLogSite& operator= (const BinaryLogSite&) = delete;
+
+		const char* format;
+		Severity severity;
+		const char* file;
+		u32 line;
+		u32 id;
+
+	private:
+		const BinaryLogSite* next;
+		friend class BinaryLogger;
+	};
+
+	/*
+		Logging without formatting on the hot path.
+		Log copies the site id, a steady clock timestamp and the raw bytes of every argument into a buffer owned by the calling thread,
+		without locks, string conversions or stream construction. Dump appends everything logged since the previous dump to a file,
+		which the LogDecoder turns back into the usual text log. Format strings use {} as placeholder, arguments without one are appended.
+		A thread holds at most max_chunks undumped chunks, records logged past that are dropped and their count is written to the next dump.
+	*/
+	class BinaryLogger
+	{
+	public:
+#		ifdef RV_BINARY_LOGGER
+		static constexpr bool enabled = true;
+#		else
+		static constexpr bool enabled = false;
+#		endif
+
+		static constexpr size_t chunk_size = 64 * 1024;
+		static constexpr size_t max_chunks = 64;
+		static constexpr size_t max_arguments = 32;
+		// longer strings are truncated, so a record always fits in a chunk
+		static constexpr size_t max_string_size = 1024;
+		static constexpr const char* default_path = "Rave.binlog";
+
+		BinaryLogger();
+		BinaryLogger(const BinaryLogger&) = delete;
+
+		BinaryLogger& operator= (const BinaryLogger&) = delete;
+
+		template<typename... Args>
+		void Log(const BinaryLogSite& site, const Args&... args)
+		{
+			static_assert(sizeof...(Args) <= max_arguments, "Too many binary log arguments");
+
+			const size_t size = sizeof(u32) + sizeof(i64) + sizeof(u8) + (ArgumentSize(args) + ... + 0);
+			ThreadBuffer* buffer = LocalBuffer();
+			byte* out = buffer ? buffer->Reserve(size) : nullptr;
+			if (!out)
+				return Drop(buffer);
+			Write(out, site.id);
+			Write(out, (i64)std::chrono::steady_clock::now().time_since_epoch().count());
+			Write(out, (u8)sizeof...(Args));
+			(WriteArgument(out, args), ...);
+			buffer->Commit(size);
+		}
+
+		// Appends everything logged since the previous dump to the file, a different path starts a new file. Can be called from any thread
+		bool Dump(const char* path = default_path);
+
+	private:
+		struct Chunk
+		{
+			Chunk* next = nullptr;
+			std::atomic<size_t> size = 0;
+			byte data[chunk_size];
+		};
+
+		struct ThreadBuffer
+		{
+			ThreadBuffer(u64 thread);
+			ThreadBuffer(const ThreadBuffer&) = delete;
+			~ThreadBuffer();
+
+			ThreadBuffer& operator= (const ThreadBuffer&) = delete;
+
+			// Returns null when the thread already holds max_chunks. Owning thread only
+			byte* Reserve(size_t size)
+			{
+				const size_t used = current->size.load(std::memory_order_relaxed);
+				if (used + size > chunk_size)
+					return Grow();
+				return current->data + used;
+			}
+			// Publishes the reserved bytes to Dump. Owning thread only
+			void Commit(size_t size)
+			{
+				current->size.store(current->size.load(std::memory_order_relaxed) + size, std::memory_order_release);
+			}
+
+			byte* Grow();
+
+			u64 thread;
+			Chunk* first;
+			Chunk* current;
+			// chunks from first to current
+			size_t chunks = 1;
+			// dumped chunks, reused by Grow
+			Chunk* free = nullptr;
+			// bytes of the first chunk that were already dumped
+			size_t dumped = 0;
+			// records that didn't fit, only incremented by the owning thread
+			std::atomic<u64> dropped = 0;
+			u64 droppedDumped = 0;
+			// set once the owning thread no longer writes to the buffer, it is freed by the next dump
+			std::atomic<bool> abandoned = false;
+			std::mutex chunkMutex;
+		};
+
+		template<typename T>
+		static constexpr bool is_character = std::is_same_v<T, char> || std::is_same_v<T, char8_t> || std::is_same_v<T, char16_t> || std::is_same_v<T, char32_t> || std::is_same_v<T, wchar_t>;
+
+		template<typename T>
+		static size_t ArgumentSize(const T& value)
+		{
+			if constexpr (std::is_same_v<T, bool>)
+				return sizeof(u8) + sizeof(u8);
+			else if constexpr (is_character<T> || std::is_arithmetic_v<T> || std::is_enum_v<T>)
+				return sizeof(u8) + sizeof(u64);
+			else
+				return sizeof(u8) + sizeof(u32) + StringSize(StringView(value));
+		}
+
+		template<typename T>
+		static void WriteArgument(byte*& out, const T& value)
+		{
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				Write(out, RV_BINARY_LOG_BOOL);
+				Write(out, (u8)value);
+			}
+			else if constexpr (is_character<T>)
+			{
+				Write(out, RV_BINARY_LOG_CHAR);
+				Write(out, (u64)(std::make_unsigned_t<T>)value);
+			}
+			else if constexpr (std::is_floating_point_v<T>)
+			{
+				Write(out, RV_BINARY_LOG_FLOAT);
+				Write(out, (double)value);
+			}
+			else if constexpr (std::is_enum_v<T>)
+			{
+				WriteArgument(out, (std::underlying_type_t<T>)value);
+			}
+			else if constexpr (std::is_signed_v<T>)
+			{
+				Write(out, RV_BINARY_LOG_SIGNED);
+				Write(out, (i64)value);
+			}
+			else if constexpr (std::is_unsigned_v<T>)
+			{
+				Write(out, RV_BINARY_LOG_UNSIGNED);
+				Write(out, (u64)value);
+			}
+			else
+			{
+				auto string = StringView(value);
+				using C = typename decltype(string)::value_type;
+				Write(out, sizeof(C) == 1 ? RV_BINARY_LOG_UTF8 : sizeof(C) == 2 ? RV_BINARY_LOG_UTF16 : RV_BINARY_LOG_UTF32);
+				const u32 size = (u32)StringSize(string);
+				Write(out, size);
+				std::memcpy(out, string.data(), size);
+				out += size;
+			}
+		}
+
+		template<typename T>
+		static auto StringView(const T& value)
+		{
+			if constexpr (std::is_convertible_v<const T&, std::string_view>)
+				return std::string_view(value);
+			else if constexpr (std::is_convertible_v<const T&, std::u8string_view>)
+				return std::u8string_view(value);
+			else if constexpr (std::is_convertible_v<const T&, std::u16string_view>)
+				return std::u16string_view(value);
+			else if constexpr (std::is_convertible_v<const T&, std::u32string_view>)
+				return std::u32string_view(value);
+			else if constexpr (std::is_convertible_v<const T&, std::wstring_view>)
+				return std::wstring_view(value);
+			else
+				static_assert(!sizeof(T), "Unsupported binary log argument, only arithmetic types, enums, characters and strings can be logged");
+		}
+
+		template<typename C>
+		static size_t StringSize(std::basic_string_view<C> string)
+		{
+			// truncated on a code unit boundary
+			const size_t size = string.size() * sizeof(C);
+			return size < max_string_size ? size : max_string_size - max_string_size % sizeof(C);
+		}
+
+		template<typename T>
+		static void Write(byte*& out, const T& value)
+		{
+			std::memcpy(out, &value, sizeof(T));
+			out += sizeof(T);
+		}
+
+		// Returns null once the calling thread has released its buffer on exit
+		ThreadBuffer* LocalBuffer();
+		std::shared_ptr<ThreadBuffer> RegisterThread();
+		void Drop(ThreadBuffer* buffer);
+		static void Collect(ThreadBuffer& buffer, std::vector<byte>& out);
+
+	private:
+		// shared with the owning thread, so neither the thread's exit nor the logger's destruction has to wait for the other
+		std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+		std::mutex bufferMutex;
+		// records of threads that were already exiting and had no buffer left
+		std::atomic<u64> lost = 0;
+		std::ofstream file;
+		std::string filePath;
+		u32 sitesWritten = 0;
+		std::mutex dumpMutex;
+		u64 id;
+	};
+
+	extern BinaryLogger binlog;
+}
+
+#ifdef RV_BINARY_LOGGER
+#define rv_binlog_severity(severity, format, ...)	do { static const rv::BinaryLogSite rv_binlog_site(format, severity, __FILE__, __LINE__); rv::binlog.Log(rv_binlog_site, ##__VA_ARGS__); } while (false)
+
+#define rv_binlog(format, ...)						rv_binlog_severity(rv::RV_SEVERITY_INFO, format, ##__VA_ARGS__)
+#define rv_binlog_info(format, ...)					rv_binlog_severity(rv::RV_SEVERITY_INFO, format, ##__VA_ARGS__)
+#define rv_binlog_warning(format, ...)				rv_binlog_severity(rv::RV_SEVERITY_WARNING, format, ##__VA_ARGS__)
+#define rv_binlog_error(format, ...)				rv_binlog_severity(rv::RV_SEVERITY_ERROR, format, ##__VA_ARGS__)
+#else
+#define rv_binlog_severity(severity, format, ...)
+#define rv_binlog(format, ...)
+#define rv_binlog_info(format, ...)
+#define rv_binlog_warning(format, ...)
+#define rv_binlog_error(format, ...)
+#endif
\ No newline at end of file
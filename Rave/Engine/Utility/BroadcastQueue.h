@@ -0,0 +1,224 @@
+#pragma once
+#include "Engine/Utility/Queue.h"
+#include "Engine/Utility/MpscQueue.h"
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace rv
+{
+	/*
+		Lock-free MPSC queue of references to shared, immutable queue headers.
+		A broadcast builds its header once and every listener queue only links to it,
+		so posting to N listeners costs N small links instead of N copies of the payload.
+	*/
+	template<typename I = EmptyInfo, BlockAllocator A = DefaultAllocator>
+	class BroadcastQueue
+	{
+	public:
+		using Header = typename Queue<I, A>::Header;
+
+		BroadcastQueue() = default;
+		BroadcastQueue(const BroadcastQueue&) = delete;
+		~BroadcastQueue()
+		{
+			Release(links.PopAll());
+			for (auto& [key, header] : slots)
+				Queue<I, A>::Release(header);
+		}
+
+		BroadcastQueue& operator= (const BroadcastQueue&) = delete;
+
+		// Adds a reference to the header for this queue. Can be called from any thread
+		void Push(Header* header)
+		{
+			Queue<I, A>::AddReference(header);
+			links.Push(MakeLink(header));
+		}
+
+		// Adds a reference to every header and publishes them in order with a single queue operation. Can be called from any thread
+		void Push(Header* const* headers, size_t count)
+		{
+			if (count == 0)
+				return;
+
+			Link* first = nullptr;
+			for (size_t i = count; i-- > 0;)
+			{
+				Queue<I, A>::AddReference(headers[i]);
+				Link* link = MakeLink(headers[i]);
+				link->next = first;
+				first = link;
+			}
+			links.Push(first);
+		}
+
+		/*
+			Coalesced pushes with the same key share a slot in the queue.
+			While a header is pending in the slot, newer pushes replace it in place instead of being appended.
+			The slot is removed again once the consumer takes its header.
+			Can be called from any thread
+		*/
+		void PushLatest(u64 key, Header* header)
+		{
+			Queue<I, A>::AddReference(header);
+			Header* replaced = nullptr;
+			Link* link = nullptr;
+			{
+				std::lock_guard guard(slotMutex);
+				auto [it, inserted] = slots.try_emplace(key, header);
+				if (inserted)
+					link = MakeLink(nullptr, key);
+				else
+					replaced = std::exchange(it->second, header);
+			}
+			if (link)
+				links.Push(link);
+			Queue<I, A>::Release(replaced);
+		}
+
+		/*
+			Like PushLatest, but a pending header is replaced by merge(pending, header), which returns a new header.
+			merge runs outside the slot lock, if the pending header changes meanwhile the merge is redone against the new one
+		*/
+		template<typename M>
+		void PushMerged(u64 key, Header* header, M&& merge)
+		{
+			while (true)
+			{
+				Header* pending = nullptr;
+				Link* link = nullptr;
+				{
+					std::lock_guard guard(slotMutex);
+					auto [it, inserted] = slots.try_emplace(key, header);
+					if (inserted)
+					{
+						Queue<I, A>::AddReference(header);
+						link = MakeLink(nullptr, key);
+					}
+					else
+					{
+						// keeps the pending header alive and its address unique while merging
+						pending = it->second;
+						Queue<I, A>::AddReference(pending);
+					}
+				}
+				if (link)
+				{
+					links.Push(link);
+					return;
+				}
+
+				Header* merged = merge(pending, header);
+				bool swapped = false;
+				{
+					std::lock_guard guard(slotMutex);
+					auto it = slots.find(key);
+					if (it != slots.end() && it->second == pending)
+					{
+						it->second = merged;
+						swapped = true;
+					}
+				}
+				if (swapped)
+				{
+					// drops both the slot's reference and the one taken for the merge
+					Queue<I, A>::Release(pending);
+					Queue<I, A>::Release(pending);
+					return;
+				}
+				Queue<I, A>::Release(merged);
+				Queue<I, A>::Release(pending);
+			}
+		}
+
+		// The caller takes over the queue's reference to the returned header. Consumer only
+		Header* Pop()
+		{
+			while (Link* link = links.Pop())
+			{
+				Header* header = Take(link);
+				FreeLink(link);
+				if (header)
+					return header;
+			}
+			return nullptr;
+		}
+
+		// Takes every queued header at once and hands them to consume in FIFO order, together with their references. Consumer only
+		template<typename F>
+		size_t Drain(F&& consume)
+		{
+			size_t count = 0;
+			Link* link = links.PopAll();
+			while (link)
+			{
+				Link* next = link->next;
+				if (Header* header = Take(link))
+				{
+					consume(header);
+					++count;
+				}
+				FreeLink(link);
+				link = next;
+			}
+			return count;
+		}
+
+		// Consumer only
+		bool Empty() const
+		{
+			return links.Empty();
+		}
+
+	private:
+		struct Link
+		{
+			Link(Header* header, u64 key) : header(header), key(key) {}
+
+			Link* next = nullptr;
+			// null for coalesced links, the header is taken from the slot of key when the link is consumed
+			Header* header;
+			u64 key;
+		};
+
+		static Link* MakeLink(Header* header, u64 key = 0)
+		{
+			return new (A::Allocate(sizeof(Link), alignof(Link))) Link(header, key);
+		}
+
+		Header* Take(Link* link)
+		{
+			if (link->header)
+				return link->header;
+			std::lock_guard guard(slotMutex);
+			auto it = slots.find(link->key);
+			Header* header = it->second;
+			slots.erase(it);
+			return header;
+		}
+
+		static void FreeLink(Link* link)
+		{
+			link->~Link();
+			A::Free(link, sizeof(Link), alignof(Link));
+		}
+
+		static void Release(Link* link)
+		{
+			while (link)
+			{
+				Link* next = link->next;
+				Queue<I, A>::Release(link->header);
+				FreeLink(link);
+				link = next;
+			}
+		}
+
+	private:
+		MpscQueue<Link> links;
+		// headers pending in a coalesced link, by key
+		std::unordered_map<u64, Header*> slots;
+		std::mutex slotMutex;
+	};
+}
\ No newline at end of file
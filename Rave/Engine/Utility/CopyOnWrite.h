@@ -0,0 +1,139 @@
+#pragma once
+#include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace rv
+{
+	namespace detail
+	{
+		/*
+			Versions a thread is reading, published so writers know which retired versions they can't delete yet.
+			Every slot is only written by the thread that claimed it, so readers never share a cache line.
+		*/
+		struct alignas(64) ReaderSlots
+		{
+			static constexpr size_t count = 4;
+
+			std::atomic<const void*> versions[count] = {};
+			std::atomic<bool> claimed = false;
+			// every record ever created
+			ReaderSlots* next = nullptr;
+			// the next record claimed by the same thread, only used by that thread
+			ReaderSlots* owned = nullptr;
+			// shared by reads of threads that already ran their thread_local destructors, each slot is claimed on its own
+			bool shared = false;
+		};
+
+		// Returns an unused slot of the calling thread, set it back to null once the read is done
+		std::atomic<const void*>& acquire_reader_slot();
+		// Appends every version that is being read by any thread
+		void collect_read_versions(std::vector<const void*>& versions);
+	}
+
+	/*
+		Read-copy-update container for data that is read on hot paths and rarely changed, like listener registries.
+		Readers pin the current version in a slot owned by their thread, they never lock, never wait on writers and never touch shared counters.
+		Writers copy the current version, change the copy and publish it with a single exchange.
+		Replaced versions are retired and deleted by the next writer that finds no reader pinning them.
+	*/
+	template<typename T>
+	class CopyOnWrite
+	{
+	public:
+		// Keeps the version it was created with alive, should only be held for the duration of a read
+		class Snapshot
+		{
+		public:
+			Snapshot(const Snapshot&) = delete;
+			~Snapshot() { slot.store(nullptr, std::memory_order_release); }
+
+			Snapshot& operator= (const Snapshot&) = delete;
+
+			const T& operator* () const { return *value; }
+			const T* operator-> () const { return value; }
+
+		private:
+			Snapshot(std::atomic<const void*>& slot, const T* value) : slot(slot), value(value) {}
+
+			std::atomic<const void*>& slot;
+			const T* value;
+			friend class CopyOnWrite;
+		};
+
+		CopyOnWrite() : current(new T()) {}
+		CopyOnWrite(const CopyOnWrite&) = delete;
+		~CopyOnWrite()
+		{
+			delete current.load(std::memory_order_relaxed);
+			for (T* version : retired)
+				delete version;
+		}
+
+		CopyOnWrite& operator= (const CopyOnWrite&) = delete;
+
+		// Can be called from any thread
+		Snapshot Read() const
+		{
+			std::atomic<const void*>& slot = detail::acquire_reader_slot();
+			const T* value = current.load(std::memory_order_relaxed);
+			while (true)
+			{
+				// a writer that retires value after this store sees it pinned, if it retired it before we load the new version
+				slot.store(value, std::memory_order_seq_cst);
+				const T* latest = current.load(std::memory_order_seq_cst);
+				if (latest == value)
+					break;
+				value = latest;
+			}
+			return Snapshot(slot, value);
+		}
+
+		// Publishes a copy of the current version changed by modify. Writers are serialized, readers are not blocked
+		template<typename F>
+		void Update(F&& modify)
+		{
+			std::lock_guard guard(writeMutex);
+			Publish(modify);
+		}
+
+		// Like Update, but gives up instead of waiting when another writer is busy
+		template<typename F>
+		bool TryUpdate(F&& modify)
+		{
+			std::unique_lock guard(writeMutex, std::try_to_lock);
+			if (!guard)
+				return false;
+			Publish(modify);
+			return true;
+		}
+
+	private:
+		template<typename F>
+		void Publish(F& modify)
+		{
+			T* next = new T(*current.load(std::memory_order_relaxed));
+			modify(*next);
+			retired.push_back(current.exchange(next, std::memory_order_seq_cst));
+
+			// readers that start from now on see the new version, so only versions pinned right now have to stay
+			pinned.clear();
+			detail::collect_read_versions(pinned);
+			std::erase_if(retired, [this](T* version)
+				{
+					if (std::find(pinned.begin(), pinned.end(), version) != pinned.end())
+						return false;
+					delete version;
+					return true;
+				}
+			);
+		}
+
+	private:
+		std::atomic<T*> current;
+		std::vector<T*> retired;
+		std::vector<const void*> pinned;
+		std::mutex writeMutex;
+	};
+}
\ No newline at end of file
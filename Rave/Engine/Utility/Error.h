@@ -67,6 +67,7 @@ namespace rv
 	static constexpr Identifier32 file_result = "Assertion Result";
 	static constexpr Identifier32 hr_result = "HRESULT";
 	static constexpr Identifier32 vkr_result = "VkResult";
+	static constexpr Identifier32 vulkan_debug_result = "Vulkan Debug Result";
 
 
 	static constexpr Result succeeded_condition = Result(RV_SEVERITY_INFO, condition_result);
@@ -1,42 +1,127 @@
 #pragma once
 #include "Engine/Utility/Types.h"
 #include "Engine/Utility/Queue.h"
+#include "Engine/Utility/BroadcastQueue.h"
+#include "Engine/Utility/CopyOnWrite.h"
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 
 namespace rv
 {
+	template<typename E>
+	concept MergeableEvent = requires(E pending, const E& incoming) { pending.Merge(incoming); };
+
+	// Combines a pending event with a newer one into a new header
+	typedef Queue<EmptyInfo>::Header* (*EventMerger)(const Queue<EmptyInfo>::Header* pending, const Queue<EmptyInfo>::Header* incoming);
+
+	namespace detail
+	{
+		template<MergeableEvent E>
+		static Queue<EmptyInfo>::Header* merge_events(const Queue<EmptyInfo>::Header* pending, const Queue<EmptyInfo>::Header* incoming)
+		{
+			E merged = *pending->data<E>();
+			merged.Merge(*incoming->data<E>());
+			return Queue<EmptyInfo>::MakeEntry(EmptyInfo(), std::move(merged));
+		}
+	}
+
 	struct EventQueue
 	{
 		EventQueue() = default;
 
-		Queue<EmptyInfo> queue;
-		std::mutex mutex;
+		void Push(Queue<EmptyInfo>::Header* header);
+		void Push(Queue<EmptyInfo>::Header* const* headers, size_t count);
+		// A null merger means the latest event wins
+		void Push(Queue<EmptyInfo>::Header* header, EventMerger merger);
+		bool Wait(std::chrono::nanoseconds timeout);
+		void Wait();
+		// Marks the queue as abandoned by its listener, loggers stop delivering to it
+		void Close();
+		bool Closed() const;
+
+		BroadcastQueue<EmptyInfo> queue;
+
+	private:
+		void Notify();
+
+		std::atomic<bool> closed = false;
+		std::atomic<bool> waiting = false;
+		std::mutex waitMutex;
+		std::condition_variable signal;
 	};
 
 	class EventLogger
 	{
 	public:
 		template<typename E>
-		void PostEvent(const E& event)
+		void PostEvent(E&& event)
 		{
-			std::lock_guard global_guard(mutex);
-			for (auto& listener : listeners)
+			bool stale = false;
 			{
-				if (listener.use_count() == 1)
-				{
-					listener.reset();
-					continue;
-				}
-				std::lock_guard guard(listener->mutex);
-				listener->queue.PushEntry(EmptyInfo(), event);
+				auto registry = this->registry.Read();
+				if (!registry->Subscribed(type_id<std::remove_cvref_t<E>>()))
+					return;
+
+				// the event is built once and shared by every listener
+				Queue<EmptyInfo>::Header* header = Queue<EmptyInfo>::MakeEntry(EmptyInfo(), std::forward<E>(event));
+				stale = !Post(*registry, header);
+				Queue<EmptyInfo>::Release(header);
 			}
+			if (stale)
+				Compact();
+		}
+
+		// A pending event of type E is replaced by newer events of that type instead of queueing them all
+		template<typename E>
+		void CoalesceEvents()
+		{
+			registry.Update([](Registry& registry) { registry.coalescing[type_id<E>()] = nullptr; });
+		}
+		// A pending event of type E is merged with newer events of that type through E::Merge
+		template<MergeableEvent E>
+		void MergeEvents()
+		{
+			registry.Update([](Registry& registry) { registry.coalescing[type_id<E>()] = detail::merge_events<E>; });
 		}
 
+	protected:
+		// Delivers already built events in order, with one queue operation per listener. The caller keeps its references. Events are not coalesced
+		void PostBatch(Queue<EmptyInfo>::Header* const* headers, size_t count);
+
+	private:
+		using ListenerList = std::vector<std::shared_ptr<EventQueue>>;
+
+		/*
+			Immutable once published, posting only reads the current registry.
+			Listeners that stopped listening are skipped and dropped by the next update.
+		*/
+		struct Registry
+		{
+			bool Subscribed(u64 type) const;
+			void Compact();
+
+			// listeners that receive every event
+			ListenerList listeners;
+			// listeners that only subscribed to specific event types, keyed on the type
+			std::unordered_map<u64, ListenerList> typedListeners;
+			// event types that are coalesced while pending, with the merger to use
+			std::unordered_map<u64, EventMerger> coalescing;
+		};
+
+		// Returns false if a listener stopped listening
+		static bool Post(const Registry& registry, Queue<EmptyInfo>::Header* header);
+		static bool Deliver(const ListenerList& list, Queue<EmptyInfo>::Header* header);
+		static bool Deliver(const ListenerList& list, Queue<EmptyInfo>::Header* header, EventMerger merger);
+		static bool Collect(const ListenerList& list, Queue<EmptyInfo>::Header* header, std::unordered_map<EventQueue*, std::vector<Queue<EmptyInfo>::Header*>>& batches);
+		void Compact();
+
 	private:
-		std::vector<std::shared_ptr<EventQueue>> listeners;
-		std::mutex mutex;
+		CopyOnWrite<Registry> registry;
 		friend class EventListener;
 	};
 
@@ -44,14 +129,19 @@ namespace rv
 	{
 	protected:
 		template<typename E>
-		void PostEvent(const E& event)
+		void PostEvent(E&& event)
 		{
-			logger.PostEvent(event);
+			logger.PostEvent(std::forward<E>(event));
 		}
 		template<typename E>
-		void PostEvent(E&& event)
+		void CoalesceEvents()
 		{
-			logger.PostEvent(std::move(event));
+			logger.CoalesceEvents<E>();
+		}
+		template<MergeableEvent E>
+		void MergeEvents()
+		{
+			logger.MergeEvents<E>();
 		}
 
 	private:
@@ -74,11 +164,12 @@ namespace rv
 		operator bool() const;
 		bool Empty() const;
 
+		// The type_id of the event's data, 0 if the event is empty
+		u64 Type() const { return header ? header->type : 0; }
 		template<typename E>
-		bool IsType() const { return header ? (header->type == typeid(E).hash_code()) : false; }
+		bool IsType() const { return header ? (header->type == type_id<E>()) : false; }
 
-		template<typename E>
-		E& Get() { return *header->data<E>(); }
+		// Events are shared by every listener and can't be modified
 		template<typename E>
 		const E& Get() const { return *header->data<E>(); }
 
@@ -94,12 +185,46 @@ namespace rv
 		EventListener() = default;
 		EventListener(EventLogger& logger);
 		EventListener(EventSource& source);
+		EventListener(const EventListener&) = delete;
+		EventListener(EventListener&& rhs) noexcept;
+		~EventListener();
+
+		EventListener& operator= (const EventListener&) = delete;
+		EventListener& operator= (EventListener&& rhs) noexcept;
 
 		void Listen(EventLogger& logger);
 		void Listen(EventSource& source);
+
+		// Only receive events of the given types, e.g. Listen<FailedResult, ResizeEvent>(source)
+		template<typename E, typename... Es>
+		void Listen(EventLogger& logger)
+		{
+			StopListening();
+			events = std::make_shared<EventQueue>();
+			logger.registry.Update([this](EventLogger::Registry& registry)
+				{
+					registry.Compact();
+					registry.typedListeners[type_id<E>()].push_back(events);
+					(registry.typedListeners[type_id<Es>()].push_back(events), ...);
+				}
+			);
+		}
+		template<typename E, typename... Es>
+		void Listen(EventSource& source)
+		{
+			Listen<E, Es...>(source.logger);
+		}
+
 		void StopListening();
 
+		// Events are consumed by a single thread, posting can happen from any thread
 		Event GetEvent();
+		// Sleeps until an event arrives
+		Event WaitEvent();
+		// Sleeps until an event arrives or the timeout expires, in which case the returned event is empty
+		Event WaitEvent(std::chrono::nanoseconds timeout);
+		// Appends every pending event to out at once, returns the amount of events added
+		size_t DrainEvents(std::vector<Event>& out);
 
 	private:
 		std::shared_ptr<EventQueue> events;
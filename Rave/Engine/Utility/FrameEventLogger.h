@@ -0,0 +1,58 @@
+#pragma once
+#include "Engine/Utility/Event.h"
+#include <chrono>
+#include <thread>
+
+namespace rv
+{
+	/*
+		Deferred, frame scoped delivery of events.
+		DeferEvent appends the event to a buffer owned by the calling thread, without any locks or atomic operations.
+		PostEvent is still inherited from EventLogger and delivers immediately, so code holding an EventLogger& is unaffected.
+		Flush merges every thread's buffer into one batch, ordered on the time the events were posted,
+		and hands each listener its share of the batch with a single queue operation.
+
+		Flush has to be called at a frame boundary, when no thread is posting to this logger,
+		e.g. after the frame's jobs have been joined. Events posted afterwards fill the next frame's buffers
+		while listeners are still consuming the previous batch.
+	*/
+	class FrameEventLogger : public EventLogger
+	{
+	public:
+		FrameEventLogger();
+		FrameEventLogger(const FrameEventLogger&) = delete;
+		~FrameEventLogger();
+
+		FrameEventLogger& operator= (const FrameEventLogger&) = delete;
+
+		// The event is only delivered on the next Flush
+		template<typename E>
+		void DeferEvent(E&& event)
+		{
+			LocalBuffer().records.push_back({ std::chrono::steady_clock::now().time_since_epoch().count(), Queue<EmptyInfo>::MakeEntry(EmptyInfo(), std::forward<E>(event)) });
+		}
+
+		void Flush();
+
+	private:
+		struct Record
+		{
+			i64 stamp;
+			Queue<EmptyInfo>::Header* header;
+		};
+		struct ThreadBuffer
+		{
+			std::vector<Record> records;
+		};
+
+		ThreadBuffer& LocalBuffer();
+		ThreadBuffer& RegisterThread();
+
+	private:
+		std::unordered_map<std::thread::id, std::unique_ptr<ThreadBuffer>> buffers;
+		std::vector<Record> merged;
+		std::vector<Queue<EmptyInfo>::Header*> batch;
+		std::mutex bufferMutex;
+		u64 id;
+	};
+}
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 #include "Engine/Utility/Types.h"
 #include "Engine/Utility/Concepts.h"
+#include "Engine/Utility/Xxh3.h"
+#include <concepts>
 #include <type_traits>
+#include <string>
 #include <string_view>
 
 namespace rv
@@ -15,6 +18,38 @@ namespace rv
 		return h1 ^ (h2 + (H)0x9e3779b9 + (h1 << 6) + (h1 >> 2));
 	}
 
+	static constexpr Hash128 combine_hash(const Hash128& h1, const Hash128& h2)
+	{
+		return { combine_hash(h1.low, h2.low), combine_hash(h1.high, h2.high) };
+	}
+
+	/*
+		Hash engines, e.g. hash<Xxh3>(blob), hash hashed values as one byte stream instead of byte by byte like FNV-1a.
+		They are meant for large inputs like shaders, pipeline state and assets, and still work at compile time.
+	*/
+	struct Xxh3
+	{
+		typedef u64 result_type;
+
+		template<typename T>
+		static constexpr u64 Hash(const T* data, size_t count) { return detail::xxh3::hash_64(detail::HashInput<T>{ data, count * sizeof(T) }); }
+	};
+
+	struct Xxh3_128
+	{
+		typedef Hash128 result_type;
+
+		template<typename T>
+		static constexpr Hash128 Hash(const T* data, size_t count) { return detail::xxh3::hash_128(detail::HashInput<T>{ data, count * sizeof(T) }); }
+	};
+
+	template<typename H>
+	concept HashEngine = requires(const u8* data, size_t count)
+	{
+		typename H::result_type;
+		{ H::Hash(data, count) } -> std::same_as<typename H::result_type>;
+	};
+
 	namespace detail
 	{
 		template<HashType H>
@@ -145,12 +180,68 @@ namespace rv
 				h = combine_hash(h, hash<H>(args...));
 			return h;
 		}
+
+		// Contiguous containers of trivially copyable values are hashed as one byte stream
+		template<typename T>
+		concept ContiguousHashable = requires(const T& value)
+		{
+			{ value.data() } -> std::convertible_to<const typename T::value_type*>;
+			{ value.size() } -> std::convertible_to<size_t>;
+		} && std::is_trivially_copyable_v<typename T::value_type>;
+
+		template<HashEngine E, typename T>
+		static constexpr typename E::result_type engine_hash_element(const T& value)
+		{
+			// before strings, so literals are hashed as the whole array including the terminator, like FNV-1a does
+			if constexpr (std::is_array_v<T> && std::is_trivially_copyable_v<std::remove_all_extents_t<T>>)
+				return E::Hash(value, std::extent_v<T>);
+
+			else if constexpr (CStringType<T>)
+			{
+				if (value)
+					return E::Hash(value, std::char_traits<std::remove_cvref_t<decltype(*value)>>::length(value));
+				else
+					return E::Hash(static_cast<const u8*>(nullptr), 0);
+			}
+
+			else if constexpr (ContiguousHashable<T>)
+				return E::Hash(value.data(), value.size());
+
+			else if constexpr (RangeType<T>)
+			{
+				typename E::result_type h = E::Hash(static_cast<const u8*>(nullptr), 0);
+				for (const auto& element : value)
+					h = combine_hash(h, engine_hash_element<E>(element));
+				return h;
+			}
+
+			else
+				return E::Hash(&value, 1);
+		}
+
+		template<HashEngine E, typename F, typename... Args>
+		static constexpr typename E::result_type engine_hash(const F& value, const Args&... args)
+		{
+			typename E::result_type h = engine_hash_element<E>(value);
+			if constexpr (NonEmpty<Args...>)
+				h = combine_hash(h, engine_hash<E>(args...));
+			return h;
+		}
 	}
 
-	template<HashType H = size_t, typename... Args>
-	static constexpr H hash(const Args&... args)
+	// H is either the unsigned type of an FNV-1a hash or a hash engine like Xxh3
+	template<typename H = size_t, typename... Args>
+	requires HashType<H> || HashEngine<H>
+	static constexpr auto hash(const Args&... args)
 	{
-		if constexpr (NonEmpty<Args...>)
+		if constexpr (HashEngine<H>)
+		{
+			if constexpr (NonEmpty<Args...>)
+				return detail::engine_hash<H>(args...);
+			else
+				return H::Hash(static_cast<const u8*>(nullptr), 0);
+		}
+		else if constexpr (NonEmpty<Args...>)
 			return detail::hash<H>(args...);
 		else
 			return detail::HashInfo<H>::basis;
@@ -0,0 +1,108 @@
+#pragma once
+#include "Engine/Utility/Types.h"
+#include "Engine/Utility/Hash.h"
+
+namespace rv
+{
+	namespace detail
+	{
+		/*
+			Streaming XXH3. Input is collected in a buffer of 4 stripes, larger updates are accumulated straight from the caller's memory.
+			The last stripe that was accumulated is kept, as the final stripe of a short tail overlaps it.
+		*/
+		class Xxh3State
+		{
+		public:
+			Xxh3State();
+
+			void Reset();
+			void Update(const u8* data, size_t size);
+
+			u64 Digest64() const;
+			Hash128 Digest128() const;
+
+		private:
+			// Accumulates whole stripes, scrambling at every block boundary. Returns the end of the accumulated input
+			static const u8* Consume(u64* accumulators, size_t& stripesInBlock, const u8* input, size_t stripes);
+			void DigestLong(u64* accumulators) const;
+
+		private:
+			static constexpr size_t buffer_size = 4 * xxh3::stripe_size;
+
+			alignas(64) u8 buffer[buffer_size];
+			u64 acc[xxh3::accumulator_count];
+			size_t buffered;
+			// stripes accumulated in the current block
+			size_t blockStripes;
+			u64 length;
+		};
+	}
+
+	/*
+		Hashes input that arrives in pieces, e.g. while a file is read or an asset is streamed in.
+		Finalize returns the same value as hash<H> over every updated byte at once, e.g. hash<Xxh3>(bytes).
+	*/
+	template<typename H>
+	class Hasher;
+
+	template<HashType H>
+	class Hasher<H>
+	{
+	public:
+		void Update(const void* data, size_t size)
+		{
+			const u8* bytes = static_cast<const u8*>(data);
+			for (size_t i = 0; i < size; ++i)
+				detail::fnv1a_shift<0>(value, bytes[i]);
+		}
+		template<detail::ContiguousHashable C>
+		void Update(const C& data)
+		{
+			Update(data.data(), data.size() * sizeof(typename C::value_type));
+		}
+
+		H Finalize() const { return value; }
+		void Reset() { value = detail::HashInfo<H>::basis; }
+
+	private:
+		H value = detail::HashInfo<H>::basis;
+	};
+
+	template<>
+	class Hasher<Xxh3>
+	{
+	public:
+		void Update(const void* data, size_t size) { state.Update(static_cast<const u8*>(data), size); }
+		template<detail::ContiguousHashable C>
+		void Update(const C& data)
+		{
+			Update(data.data(), data.size() * sizeof(typename C::value_type));
+		}
+
+		// The state is left untouched, more data can be added afterwards
+		u64 Finalize() const { return state.Digest64(); }
+		void Reset() { state.Reset(); }
+
+	private:
+		detail::Xxh3State state;
+	};
+
+	template<>
+	class Hasher<Xxh3_128>
+	{
+	public:
+		void Update(const void* data, size_t size) { state.Update(static_cast<const u8*>(data), size); }
+		template<detail::ContiguousHashable C>
+		void Update(const C& data)
+		{
+			Update(data.data(), data.size() * sizeof(typename C::value_type));
+		}
+
+		// The state is left untouched, more data can be added afterwards
+		Hash128 Finalize() const { return state.Digest128(); }
+		void Reset() { state.Reset(); }
+
+	private:
+		detail::Xxh3State state;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+#include "Engine/Utility/Types.h"
+#include "Engine/Utility/Result.h"
+#include <atomic>
+
+/*
+	Lowest severity compiled into a log channel, messages below it are removed from the build together with their arguments.
+	Define RV_LOG_MIN_SEVERITY to change it for every channel, or RV_LOG_MIN_SEVERITY_<CHANNEL> for a single one,
+	e.g. /D RV_LOG_MIN_SEVERITY=rv::RV_SEVERITY_WARNING /D RV_LOG_MIN_SEVERITY_DEVICE=rv::RV_SEVERITY_INFO
+*/
+#ifndef RV_LOG_MIN_SEVERITY
+#define RV_LOG_MIN_SEVERITY rv::RV_SEVERITY_INFO
+#endif
+
+#ifndef RV_LOG_MIN_SEVERITY_GENERAL
+#define RV_LOG_MIN_SEVERITY_GENERAL RV_LOG_MIN_SEVERITY
+#endif
+#ifndef RV_LOG_MIN_SEVERITY_CORE
+#define RV_LOG_MIN_SEVERITY_CORE RV_LOG_MIN_SEVERITY
+#endif
+#ifndef RV_LOG_MIN_SEVERITY_GRAPHICS
+#define RV_LOG_MIN_SEVERITY_GRAPHICS RV_LOG_MIN_SEVERITY
+#endif
+#ifndef RV_LOG_MIN_SEVERITY_DEVICE
+#define RV_LOG_MIN_SEVERITY_DEVICE RV_LOG_MIN_SEVERITY
+#endif
+#ifndef RV_LOG_MIN_SEVERITY_SWAPCHAIN
+#define RV_LOG_MIN_SEVERITY_SWAPCHAIN RV_LOG_MIN_SEVERITY
+#endif
+#ifndef RV_LOG_MIN_SEVERITY_VULKAN
+#define RV_LOG_MIN_SEVERITY_VULKAN RV_LOG_MIN_SEVERITY
+#endif
+#ifndef RV_LOG_MIN_SEVERITY_AUDIO
+#define RV_LOG_MIN_SEVERITY_AUDIO RV_LOG_MIN_SEVERITY
+#endif
+
+namespace rv
+{
+	enum LogChannel : u8
+	{
+		RV_LOG_CHANNEL_GENERAL		= 0,
+		RV_LOG_CHANNEL_CORE			= 1,
+		RV_LOG_CHANNEL_GRAPHICS		= 2,
+		RV_LOG_CHANNEL_DEVICE		= 3,
+		RV_LOG_CHANNEL_SWAPCHAIN	= 4,
+		RV_LOG_CHANNEL_VULKAN		= 5,
+		RV_LOG_CHANNEL_AUDIO		= 6,
+	};
+
+	static constexpr size_t log_channel_count = 7;
+
+	static constexpr const char* to_string(LogChannel channel)
+	{
+		switch (channel)
+		{
+			case RV_LOG_CHANNEL_GENERAL:	return "General";
+			case RV_LOG_CHANNEL_CORE:		return "Core";
+			case RV_LOG_CHANNEL_GRAPHICS:	return "Graphics";
+			case RV_LOG_CHANNEL_DEVICE:		return "Device";
+			case RV_LOG_CHANNEL_SWAPCHAIN:	return "Swapchain";
+			case RV_LOG_CHANNEL_VULKAN:		return "Vulkan";
+			case RV_LOG_CHANNEL_AUDIO:		return "Audio";
+			default:						return nullptr;
+		}
+	}
+
+	static constexpr Severity log_channel_minimum(LogChannel channel)
+	{
+		switch (channel)
+		{
+			case RV_LOG_CHANNEL_GENERAL:	return RV_LOG_MIN_SEVERITY_GENERAL;
+			case RV_LOG_CHANNEL_CORE:		return RV_LOG_MIN_SEVERITY_CORE;
+			case RV_LOG_CHANNEL_GRAPHICS:	return RV_LOG_MIN_SEVERITY_GRAPHICS;
+			case RV_LOG_CHANNEL_DEVICE:		return RV_LOG_MIN_SEVERITY_DEVICE;
+			case RV_LOG_CHANNEL_SWAPCHAIN:	return RV_LOG_MIN_SEVERITY_SWAPCHAIN;
+			case RV_LOG_CHANNEL_VULKAN:		return RV_LOG_MIN_SEVERITY_VULKAN;
+			case RV_LOG_CHANNEL_AUDIO:		return RV_LOG_MIN_SEVERITY_AUDIO;
+			default:						return RV_LOG_MIN_SEVERITY;
+		}
+	}
+
+	// True if messages of this severity are compiled into the channel
+	static constexpr bool log_compiled(LogChannel channel, Severity severity)
+	{
+		return severity >= log_channel_minimum(channel);
+	}
+
+	/*
+		Runtime severity thresholds of the log channels, on top of the compiled minimum.
+		The log macros check them before the message is built, so filtered messages cost a relaxed load.
+	*/
+	class LogFilter
+	{
+	public:
+		LogFilter();
+
+		bool Enabled(LogChannel channel, Severity severity) const
+		{
+			return log_compiled(channel, severity) && (u8)severity >= thresholds[channel].load(std::memory_order_relaxed);
+		}
+
+		// Messages below the minimum severity are filtered out
+		void SetThreshold(LogChannel channel, Severity minimum);
+		void SetThreshold(Severity minimum);
+		// Filters out every message of the channel
+		void Silence(LogChannel channel);
+
+	private:
+		static constexpr u8 silenced = 0xFF;
+
+		std::atomic<u8> thresholds[log_channel_count];
+	};
+}
\ No newline at end of file
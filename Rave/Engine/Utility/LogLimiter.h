@@ -0,0 +1,110 @@
+#pragma once
+#include "Engine/Utility/Types.h"
+#include "Engine/Utility/Result.h"
+#include "Engine/Utility/String.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace rv
+{
+	// Token bucket every log call site gets
+	struct LogBudget
+	{
+		// messages a site can log back to back
+		u32 burst = 20;
+		// messages per second the bucket refills with
+		u32 perSecond = 5;
+	};
+
+	/*
+		Rate limits log call sites, identified by a hash of their location or message id.
+		Messages that find their site's bucket empty are dropped without being built and counted,
+		the next message the site logs is preceded by a summary of how many were dropped.
+	*/
+	class LogLimiter
+	{
+	public:
+		// sites beyond this are not limited
+		static constexpr size_t max_sites = 256;
+
+		LogLimiter() = default;
+
+		void SetBudget(const LogBudget& budget);
+
+		// Builds the message with make only if the site has budget left, summary is set if the site dropped messages before it
+		template<typename F>
+		bool Admit(u64 site, Severity severity, F&& make, utf16_string& message, utf16_string& summary)
+		{
+			Site* entry = Find(site);
+			if (!entry)
+			{
+				message = make();
+				return true;
+			}
+
+			bool sample;
+			{
+				std::lock_guard guard(entry->mutex);
+				if (!Take(*entry, summary, sample))
+					return false;
+				entry->severity = severity;
+			}
+			message = make();
+
+			// the summary quotes the message that emptied the bucket, other messages aren't copied
+			if (sample)
+			{
+				std::lock_guard guard(entry->mutex);
+				entry->message = message;
+			}
+			return true;
+		}
+
+		// Passes the summary of every site that dropped messages since it last logged to report
+		template<typename F>
+		void Report(F&& report)
+		{
+			for (Site& site : sites)
+			{
+				if (site.key.load(std::memory_order_acquire) == 0)
+					continue;
+
+				utf16_string summary;
+				Severity severity;
+				{
+					std::lock_guard guard(site.mutex);
+					summary = Summarize(site, std::chrono::steady_clock::now());
+					severity = site.severity;
+				}
+				if (!summary.empty())
+					report(summary, severity);
+			}
+		}
+
+	private:
+		struct Site
+		{
+			std::atomic<u64> key = 0;
+			std::mutex mutex;
+			double tokens = 0;
+			// a site that was never refilled starts with a full bucket
+			std::chrono::steady_clock::time_point refilled;
+			u64 dropped = 0;
+			std::chrono::steady_clock::time_point firstDropped;
+			Severity severity = RV_SEVERITY_INFO;
+			// the last message admitted before the site ran out of budget
+			utf16_string message;
+		};
+
+		Site* Find(u64 site);
+		// sample is set if the site ran out of budget with this message
+		bool Take(Site& site, utf16_string& summary, bool& sample);
+		static utf16_string Summarize(Site& site, std::chrono::steady_clock::time_point now);
+
+	private:
+		std::atomic<u32> burst = LogBudget().burst;
+		std::atomic<u32> perSecond = LogBudget().perSecond;
+		Site sites[max_sites];
+	};
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+#include "Engine/Utility/Types.h"
+#include "Engine/Utility/Result.h"
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace rv
+{
+	/*
+		Destination of formatted log lines.
+		Lines are UTF-8 and collected in a buffer that is written in large blocks when it fills up or the sink is flushed.
+		Sinks can be written to from any thread.
+	*/
+	class LogSink
+	{
+	public:
+		static constexpr size_t buffer_size = 64 * 1024;
+
+		LogSink() = default;
+		LogSink(const LogSink&) = delete;
+		virtual ~LogSink() = default;
+
+		LogSink& operator= (const LogSink&) = delete;
+
+		// Buffers a line, the newline is added by the sink
+		void Write(std::string_view line);
+		void Flush();
+
+	protected:
+		// Writes out the buffered lines, called with the sink locked
+		virtual void WriteBuffer(std::string_view data) = 0;
+
+	protected:
+		std::mutex mutex;
+		std::string buffer;
+	};
+
+	// Writes straight to the standard output handle, bypassing the C++ streams
+	class ConsoleSink : public LogSink
+	{
+	public:
+		ConsoleSink();
+		~ConsoleSink();
+
+	protected:
+		void WriteBuffer(std::string_view data) override;
+
+	private:
+		void* handle = nullptr;
+	};
+
+	struct LogRotation
+	{
+		std::filesystem::path path;
+		// the file is rotated once it grows past maxBytes or has been open for maxAge, 0 disables a limit
+		u64 maxBytes = 16 * 1024 * 1024;
+		std::chrono::minutes maxAge = std::chrono::minutes(0);
+		// rotated files are renamed to path.1, path.2, ... and the oldest is removed past this count
+		u32 keep = 4;
+	};
+
+	// Writes to a log file that is rotated by size and age, does nothing until it's opened
+	class RotatingFileSink : public LogSink
+	{
+	public:
+		RotatingFileSink() = default;
+		~RotatingFileSink();
+
+		// An existing file at the path is rotated first, so the log of the previous run is kept
+		Result Open(const LogRotation& rotation);
+		void Close();
+
+	protected:
+		void WriteBuffer(std::string_view data) override;
+
+	private:
+		Result Create();
+		void CloseFile();
+		void Rotate();
+
+	private:
+		void* file = nullptr;
+		LogRotation rotation;
+		u64 size = 0;
+		std::chrono::steady_clock::time_point opened;
+	};
+}
\ No newline at end of file
@@ -1,16 +1,28 @@
 #pragma once
 #include "Engine/Utility/Queue.h"
+#include "Engine/Utility/BroadcastQueue.h"
+#include "Engine/Utility/CopyOnWrite.h"
 #include "Engine/Utility/TimeStamp.h"
 #include "Engine/Utility/Result.h"
 #include "Engine/Core/Build.h"
 #include "Engine/Utility/String.h"
+#include "Engine/Utility/AsyncLogWriter.h"
+#include "Engine/Utility/MappedFile.h"
+#include "Engine/Utility/LogChannel.h"
+#include "Engine/Utility/LogLimiter.h"
+#include "Engine/Utility/LogSink.h"
 #include <deque>
 #include <mutex>
+#include <filesystem>
 
 #if not defined(RV_DEBUG_LOGGER) and defined(RV_DEBUG) and not defined(RV_NO_DEBUG_LOGGER)
 #define RV_DEBUG_LOGGER
 #endif
 
+#if not defined(RV_ASYNC_LOGGER) and defined(RV_DEBUG_LOGGER) and not defined(RV_NO_ASYNC_LOGGER)
+#define RV_ASYNC_LOGGER
+#endif
+
 namespace rv
 {
 	struct LogInfo
@@ -23,14 +35,76 @@ namespace rv
 
 		utf16_string Format() const;
 		void Format(std::wostream& ss) const;
+		// Appends the line as UTF-8
+		void Format(std::string& out) const;
+	};
+
+	struct LogRetention
+	{
+		// the oldest records leave memory once either limit is reached
+		size_t maxRecords = 4096;
+		size_t maxBytes = 4 * 1024 * 1024;
+		// records that leave memory are appended to this file, without one they are discarded
+		std::filesystem::path spillFile;
+	};
+
+	/*
+		Records kept by a Logger, bounded by a LogRetention policy.
+		The newest records stay in memory, older ones are spilled to an append-only memory mapped file,
+		so memory use stays flat while the whole session can still be queried.
+	*/
+	class LogHistory
+	{
+	public:
+		LogHistory() = default;
+
+		// Applies the limits right away, a new spill file replaces the previous one
+		Result SetRetention(const LogRetention& retention);
+
+		void Push(LogInfo&& info);
+
+		// Visits every retained record oldest first, spilled records are read back from the file
+		template<typename F>
+		void ForEach(F&& visit) const
+		{
+			LogInfo info;
+			for (size_t offset = 0; ReadSpilled(offset, info);)
+				visit(static_cast<const LogInfo&>(info));
+			for (const LogInfo& record : records)
+				visit(record);
+		}
+
+		// Records in memory and in the spill file
+		size_t Size() const;
+		// Records that were discarded because there was no spill file or it could not be written
+		size_t Discarded() const;
+
+	private:
+		void Evict();
+		bool ReadSpilled(size_t& offset, LogInfo& info) const;
+		static size_t MemorySize(const LogInfo& info);
+
+	private:
+		std::deque<LogInfo> records;
+		size_t recordBytes = 0;
+		LogRetention retention;
+		MappedFile spill;
+		size_t spilled = 0;
+		size_t discarded = 0;
 	};
 
 	struct LogQueue
 	{
 		LogQueue() = default;
 
-		Queue<LogInfo> queue;
-		std::mutex mutex;
+		// Marks the queue as abandoned by its listener, loggers stop delivering to it
+		void Close();
+		bool Closed() const;
+
+		BroadcastQueue<LogInfo> queue;
+
+	private:
+		std::atomic<bool> closed = false;
 	};
 
 	class Logger
@@ -47,24 +121,56 @@ namespace rv
 			info.message = message;
 			info.severity = severity;
 
+			Post([&info, &data]() { return Queue<LogInfo>::MakeEntry(info, data); });
+
 			std::lock_guard global_guard(mutex);
-			loggedInfo.push_back(info);
-			for (auto& listener : listeners)
+			history.Push(std::move(info));
+		}
+
+		Result SetRetention(const LogRetention& retention);
+
+		// Visits every retained record oldest first, logging from the visitor deadlocks
+		template<typename F>
+		void ForEachLog(F&& visit)
+		{
+			std::lock_guard guard(mutex);
+			history.ForEach(std::forward<F>(visit));
+		}
+
+	private:
+		using ListenerList = std::vector<std::shared_ptr<LogQueue>>;
+
+		// Builds the record with make only if someone is listening and shares it between every listener
+		template<typename F>
+		void Post(F&& make)
+		{
+			bool stale = false;
 			{
-				if (listener.use_count() == 1)
-				{
-					listener.reset();
-					continue;
-				}
-				std::lock_guard guard(listener->mutex);
-				listener->queue.PushEntry(info, data);
+				auto listeners = this->listeners.Read();
+				if (listeners->empty())
+					return;
+
+				// the record is built once and shared by every listener
+				Queue<LogInfo>::Header* header = make();
+				stale = !Deliver(*listeners, header);
+				Queue<LogInfo>::Release(header);
 			}
+			if (stale)
+				Compact();
 		}
 
+		// Returns false if a listener stopped listening
+		static bool Deliver(const ListenerList& listeners, Queue<LogInfo>::Header* header);
+		static void Compact(ListenerList& listeners);
+		void Compact();
+
 	protected:
-		std::deque<LogInfo> loggedInfo;
-		std::vector<std::shared_ptr<LogQueue>> listeners;
+		LogHistory history;
+		// guards history, listeners are published separately so logging never waits on registration
 		std::mutex mutex;
+
+	private:
+		CopyOnWrite<ListenerList> listeners;
 		friend class LogListener;
 	};
 
@@ -83,18 +189,17 @@ namespace rv
 		operator bool() const;
 		bool Empty() const;
 
+		// The type_id of the event's data, 0 if the event is empty
+		u64 Type() const { return header ? header->type : 0; }
 		template<typename E>
-		bool IsType() const { return header ? (header->type == typeid(E).hash_code()) : false; }
+		bool IsType() const { return header ? (header->type == type_id<E>()) : false; }
 
-		template<typename E>
-		E& Get() { return *header->data<E>(); }
+		// Log events are shared by every listener and can't be modified
 		template<typename E>
 		const E& Get() const { return *header->data<E>(); }
 
-		TimeStamp& Time();
 		const TimeStamp& Time() const;
 
-		utf16_string& Message();
 		const utf16_string& Message() const;
 
 		Severity Severity() const;
@@ -113,10 +218,17 @@ namespace rv
 	public:
 		LogListener() = default;
 		LogListener(Logger& logger);
+		LogListener(const LogListener&) = delete;
+		LogListener(LogListener&& rhs) noexcept;
+		~LogListener();
+
+		LogListener& operator= (const LogListener&) = delete;
+		LogListener& operator= (LogListener&& rhs) noexcept;
 
 		void Listen(Logger& logger);
 		void StopListening();
 
+		// Events are consumed by a single thread, logging can happen from any thread
 		LogEvent GetEvent();
 
 	private:
@@ -135,12 +247,45 @@ namespace rv
 		template<typename I>
 		void Log(const utf16_string& message, const I& data, Severity severity = RV_SEVERITY_INFO)
 		{
-			WriteToSTD(message, severity);
+			WriteToSinks(message, severity);
 			Logger::Log(message, data, severity);
 		}
 
+		// Logs the message built by make unless its site ran out of budget
+		template<typename F>
+		void LogLimited(u64 site, Severity severity, F&& make)
+		{
+			utf16_string message, summary;
+			if (!limiter.Admit(site, severity, std::forward<F>(make), message, summary))
+				return;
+			if (!summary.empty())
+				Log(summary, severity);
+			Log(message, severity);
+		}
+
+		// Reports the messages rate limited sites dropped, then blocks until every message logged so far has been written to the console
+		void Flush();
+
+		// Checked by the log macros before a message is built
+		bool Enabled(LogChannel channel, Severity severity) const { return filter.Enabled(channel, severity); }
+		LogFilter& Filter() { return filter; }
+		LogLimiter& Limiter() { return limiter; }
+
+		// Also writes the log to a file, which is rotated by size and age
+		Result OpenLogFile(const LogRotation& rotation);
+
 	private:
-		void WriteToSTD(const utf16_string& message, Severity severity);
+		void WriteToSinks(const utf16_string& message, Severity severity);
+
+		LogFilter filter;
+		LogLimiter limiter;
+		ConsoleSink console;
+		RotatingFileSink file;
+
+#		ifdef RV_ASYNC_LOGGER
+		// output happens on the writer's thread, so logging never waits on console or file I/O
+		AsyncLogWriter writer{ &console, &file };
+#		endif
 	};
 
 #	else
@@ -154,6 +299,13 @@ namespace rv
 
 		template<typename I>
 		void Log(const utf16_string& message, const I& data, Severity severity = RV_SEVERITY_INFO) {}
+
+		template<typename F>
+		void LogLimited(u64 site, Severity severity, F&& make) {}
+
+		void Flush() {}
+
+		static constexpr bool Enabled(LogChannel channel, Severity severity) { return false; }
 	};
 
 #	endif
@@ -161,25 +313,30 @@ namespace rv
 	extern DebugLogger debug;
 }
 
+/*
+	Messages filtered out by their channel's compiled minimum or runtime threshold don't evaluate their arguments.
+	The unqualified macros log to the general channel.
+	The limited macros are for hot paths, every call site is rate limited by the debug logger's LogLimiter.
+*/
 #ifdef RV_DEBUG_LOGGER
-#define rv_log(msg)					rv::debug.Log(msg)
-#define rv_log_info(msg)			rv::debug.Log(msg, rv::RV_SEVERITY_INFO)
-#define rv_log_warning(msg)			rv::debug.Log(msg, rv::RV_SEVERITY_WARNING)
-#define rv_log_error(msg)			rv::debug.Log(msg, rv::RV_SEVERITY_ERROR)
-#define rv_log_value(value)			rv::debug.Log(rv::str16(rv::strvalid(u#value u": "), value))
-
-#define rv_logstr(...)				rv::debug.Log(rv::str16(__VA_ARGS__))
-#define rv_logstr_info(...)			rv::debug.Log(rv::str16(__VA_ARGS__), rv::RV_SEVERITY_INFO)
-#define rv_logstr_warning(...)		rv::debug.Log(rv::str16(__VA_ARGS__), rv::RV_SEVERITY_WARNING)
-#define rv_logstr_error(...)		rv::debug.Log(rv::str16(__VA_ARGS__), rv::RV_SEVERITY_ERROR)
+#define rv_log_channel(channel, severity, msg)		do { if constexpr (rv::log_compiled(channel, severity)) if (rv::debug.Enabled(channel, severity)) rv::debug.Log(msg, severity); } while (false)
+#define rv_logstr_channel(channel, severity, ...)	do { if constexpr (rv::log_compiled(channel, severity)) if (rv::debug.Enabled(channel, severity)) rv::debug.Log(rv::str16(__VA_ARGS__), severity); } while (false)
+#define rv_log_limited(channel, severity, msg)		do { if constexpr (rv::log_compiled(channel, severity)) if (rv::debug.Enabled(channel, severity)) { static constexpr rv::u64 rv_log_site = rv::hash<rv::u64>(__FILE__, __LINE__); rv::debug.LogLimited(rv_log_site, severity, [&]() { return rv::utf16_string(msg); }); } } while (false)
+#define rv_logstr_limited(channel, severity, ...)	do { if constexpr (rv::log_compiled(channel, severity)) if (rv::debug.Enabled(channel, severity)) { static constexpr rv::u64 rv_log_site = rv::hash<rv::u64>(__FILE__, __LINE__); rv::debug.LogLimited(rv_log_site, severity, [&]() { return rv::utf16_string(rv::str16(__VA_ARGS__)); }); } } while (false)
 #else
-#define rv_log(msg)			
-#define rv_log_info(msg)	
-#define rv_log_warning(msg)	
-#define rv_log_error(msg)	
-#define rv_logstr(...)				
-#define rv_logstr_info(...)			
-#define rv_logstr_warning(...)		
-#define rv_logstr_error(...)		
-
-#endif
\ No newline at end of file
+#define rv_log_channel(channel, severity, msg)
+#define rv_logstr_channel(channel, severity, ...)
+#define rv_log_limited(channel, severity, msg)
+#define rv_logstr_limited(channel, severity, ...)
+#endif
+
+#define rv_log(msg)					rv_log_channel(rv::RV_LOG_CHANNEL_GENERAL, rv::RV_SEVERITY_INFO, msg)
+#define rv_log_info(msg)			rv_log_channel(rv::RV_LOG_CHANNEL_GENERAL, rv::RV_SEVERITY_INFO, msg)
+#define rv_log_warning(msg)			rv_log_channel(rv::RV_LOG_CHANNEL_GENERAL, rv::RV_SEVERITY_WARNING, msg)
+#define rv_log_error(msg)			rv_log_channel(rv::RV_LOG_CHANNEL_GENERAL, rv::RV_SEVERITY_ERROR, msg)
+#define rv_log_value(value)			rv_logstr_channel(rv::RV_LOG_CHANNEL_GENERAL, rv::RV_SEVERITY_INFO, rv::strvalid(u#value u": "), value)
+
+#define rv_logstr(...)				rv_logstr_channel(rv::RV_LOG_CHANNEL_GENERAL, rv::RV_SEVERITY_INFO, __VA_ARGS__)
+#define rv_logstr_info(...)			rv_logstr_channel(rv::RV_LOG_CHANNEL_GENERAL, rv::RV_SEVERITY_INFO, __VA_ARGS__)
+#define rv_logstr_warning(...)		rv_logstr_channel(rv::RV_LOG_CHANNEL_GENERAL, rv::RV_SEVERITY_WARNING, __VA_ARGS__)
+#define rv_logstr_error(...)		rv_logstr_channel(rv::RV_LOG_CHANNEL_GENERAL, rv::RV_SEVERITY_ERROR, __VA_ARGS__)
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include "Engine/Utility/Types.h"
+#include "Engine/Utility/Result.h"
+#include <filesystem>
+
+namespace rv
+{
+	/*
+		Append-only file accessed through a memory mapping.
+		Appending copies straight into the mapped view, the mapping grows geometrically when it runs out of room.
+		Mapped pages are backed by the file instead of the page file, so the system can drop them from memory at any time.
+	*/
+	class MappedFile
+	{
+	public:
+		static constexpr size_t min_capacity = 1024 * 1024;
+
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		~MappedFile();
+
+		MappedFile& operator= (const MappedFile&) = delete;
+
+		// Creates the file, an existing file is truncated
+		Result Create(const std::filesystem::path& path);
+		// Truncates the file to its contents and closes it
+		void Close();
+
+		Result Append(const void* data, size_t size);
+
+		bool IsOpen() const;
+		const byte* Data() const;
+		size_t Size() const;
+
+	private:
+		Result Map(size_t capacity);
+		void Unmap();
+
+	private:
+		void* file = nullptr;
+		void* mapping = nullptr;
+		byte* view = nullptr;
+		size_t size = 0;
+		size_t capacity = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+
+namespace rv
+{
+	template<typename N>
+	concept IntrusiveNode = requires(N node) { { node.next } -> std::convertible_to<N*>; };
+
+	/*
+		Lock-free multi-producer / single-consumer queue of intrusive nodes linked through their next pointer.
+		Producers push onto an atomic stack with a single compare exchange and never wait on each other or on the consumer.
+		The consumer takes the whole stack with one exchange and reverses it into a private FIFO list,
+		so popping is contention free and the order of nodes pushed by one thread is preserved.
+		The queue does not own its nodes: whatever is left has to be popped and released by the owner.
+	*/
+	template<IntrusiveNode N>
+	class MpscQueue
+	{
+	public:
+		MpscQueue() = default;
+		MpscQueue(const MpscQueue&) = delete;
+		MpscQueue& operator= (const MpscQueue&) = delete;
+
+		// Pushes a node, or a null terminated chain of nodes as a single operation. Can be called from any thread
+		void Push(N* first)
+		{
+			N* top = Reverse(first);
+			first->next = pending.load(std::memory_order_relaxed);
+			while (!pending.compare_exchange_weak(first->next, top, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		// Consumer only
+		N* Pop()
+		{
+			if (!ready)
+				ready = Reverse(pending.exchange(nullptr, std::memory_order_acquire));
+			N* node = ready;
+			if (node)
+			{
+				ready = node->next;
+				node->next = nullptr;
+			}
+			return node;
+		}
+
+		// Removes every queued node at once and returns them as a chain in FIFO order. Consumer only
+		N* PopAll()
+		{
+			N* taken = Reverse(pending.exchange(nullptr, std::memory_order_acquire));
+			N* chain = ready;
+			ready = nullptr;
+			if (!chain)
+				return taken;
+
+			N* last = chain;
+			while (last->next)
+				last = last->next;
+			last->next = taken;
+			return chain;
+		}
+
+		// Consumer only
+		bool Empty() const
+		{
+			return !ready && !pending.load(std::memory_order_acquire);
+		}
+
+	private:
+		static N* Reverse(N* node)
+		{
+			N* reversed = nullptr;
+			while (node)
+			{
+				N* next = node->next;
+				node->next = reversed;
+				reversed = node;
+				node = next;
+			}
+			return reversed;
+		}
+
+	private:
+		std::atomic<N*> pending = nullptr;
+		N* ready = nullptr;
+	};
+}
\ No newline at end of file
@@ -1,13 +1,16 @@
 #pragma once
 #include "Engine/Utility/Types.h"
 #include "Engine/Utility/Flags.h"
-#include <typeinfo>
+#include "Engine/Utility/Allocator.h"
+#include "Engine/Utility/TypeId.h"
+#include <atomic>
+#include <type_traits>
 
 namespace rv
 {
 	struct EmptyInfo {};
 
-	template<typename I = EmptyInfo>
+	template<typename I = EmptyInfo, BlockAllocator A = DefaultAllocator>
 	class Queue
 	{
 	public:
@@ -40,34 +43,25 @@ namespace rv
 		template<typename D>
 		D* PushEntry(const I& info, const D& data)
 		{
-			return PushHeader(&(new Entry<D>(info, data))->header)->data<D>();
+			return PushHeader(MakeEntry(info, data))->template data<D>();
 		}
 		template<typename D>
-		D* PushEntry(const I& info, D&& data)
+		std::remove_cvref_t<D>* PushEntry(const I& info, D&& data)
 		{
-			return PushHeader(&(new Entry<D>(info, std::move(data)))->header)->data<D>();
+			return PushHeader(MakeEntry(info, std::forward<D>(data)))->template data<std::remove_cvref_t<D>>();
 		}
 		void* PushEntry(const I& info)
 		{
-			Header* header = new Header();
-			header->info = info;
-			header->type = typeid(void).hash_code();
-			PushHeader(header);
-			return header;
+			return PushHeader(MakeEntry(info));
 		}
 		void* PushEntry(I&& info)
 		{
-			Header* header = new Header();
-			header->info = std::move(info);
-			header->type = typeid(void).hash_code();
-			PushHeader(header);
-			return header;
+			return PushHeader(MakeEntry(std::move(info)));
 		}
 
 		void Clear()
 		{
-			if (first)
-				delete first;
+			Release(first);
 			first = nullptr;
 			last = nullptr;
 		}
@@ -84,13 +78,6 @@ namespace rv
 		struct Header
 		{
 			Header() = default;
-			~Header()
-			{
-				if (destructor)
-					destructor(data());
-				if (next)
-					delete next;
-			}
 
 			template<typename T = void>
 			T* data() { return reinterpret_cast<T*>(reinterpret_cast<byte*>(this) + dataOffset); }
@@ -101,10 +88,69 @@ namespace rv
 			Header* prev = nullptr;
 			size_t dataOffset = 0;
 			Destructor destructor = nullptr;
-			size_t type = 0;
+			u64 type = 0;
+			size_t size = sizeof(Header);
+			size_t alignment = alignof(Header);
+			std::atomic<u32> references = 1;
 			I info;
 		};
 
+		// Headers can be shared, e.g. by every listener of a broadcast. Shared headers must not be linked into a queue.
+		static void AddReference(Header* header)
+		{
+			header->references.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		/*
+			Drops a reference to the header and every header linked after it.
+			Headers without references left are destroyed together with their data, and their blocks are returned to the allocator.
+		*/
+		static void Release(Header* header)
+		{
+			while (header)
+			{
+				Header* next = header->next;
+				// the sole owner can skip the atomic decrement
+				if (header->references.load(std::memory_order_acquire) == 1 || header->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				{
+					const size_t size = header->size;
+					const size_t alignment = header->alignment;
+					if (header->destructor)
+						header->destructor(header->data());
+					header->~Header();
+					A::Free(header, size, alignment);
+				}
+				header = next;
+			}
+		}
+
+		// Creates a header that isn't linked into any queue yet, it has to be released by the caller.
+		template<typename D>
+		static Header* MakeEntry(const I& info, const D& data)
+		{
+			return &(new (A::Allocate(sizeof(Entry<D>), alignof(Entry<D>))) Entry<D>(info, data))->header;
+		}
+		template<typename D>
+		static Header* MakeEntry(const I& info, D&& data)
+		{
+			using E = Entry<std::remove_cvref_t<D>>;
+			return &(new (A::Allocate(sizeof(E), alignof(E))) E(info, std::forward<D>(data)))->header;
+		}
+		static Header* MakeEntry(const I& info)
+		{
+			Header* header = new (A::Allocate(sizeof(Header), alignof(Header))) Header();
+			header->info = info;
+			header->type = type_id<void>();
+			return header;
+		}
+		static Header* MakeEntry(I&& info)
+		{
+			Header* header = new (A::Allocate(sizeof(Header), alignof(Header))) Header();
+			header->info = std::move(info);
+			header->type = type_id<void>();
+			return header;
+		}
+
 	private:
 		template<typename D>
 		struct Entry
@@ -115,8 +161,10 @@ namespace rv
 				data(data)
 			{
 				header.info = info;
-				header.type = typeid(D).hash_code();
+				header.type = type_id<D>();
 				header.dataOffset = offsetof(Entry<D>, data) - offsetof(Entry<D>, header);
+				header.size = sizeof(Entry<D>);
+				header.alignment = alignof(Entry<D>);
 				if constexpr (std::is_class_v<D>)
 					header.destructor = make_destructor<D>;
 			}
@@ -125,8 +173,10 @@ namespace rv
 				data(std::move(data))
 			{
 				header.info = info;
-				header.type = typeid(D).hash_code();
+				header.type = type_id<D>();
 				header.dataOffset = offsetof(Entry<D>, data) - offsetof(Entry<D>, header);
+				header.size = sizeof(Entry<D>);
+				header.alignment = alignof(Entry<D>);
 				if constexpr (std::is_class_v<D>)
 					header.destructor = make_destructor<D>;
 			}
@@ -195,6 +245,9 @@ namespace rv
 						//this header is the last
 						last = header->prev;
 
+					// Release frees the whole chain after a header, so it must not reach the entries still queued
+					header->next = nullptr;
+					header->prev = nullptr;
 					return header;
 				}
 			}
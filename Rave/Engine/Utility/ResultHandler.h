@@ -3,10 +3,15 @@
 #include "Engine/Utility/Queue.h"
 #include "Engine/Core/Build.h"
 #include "Engine/Utility/String.h"
+#include "Engine/Utility/TimeStamp.h"
 #include <exception>
 #include <sstream>
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #ifndef RV_LOG_RESULTS
 #if defined(RV_DEBUG) and not defined(RV_NO_LOG_RESULTS)
@@ -19,6 +24,101 @@ namespace rv
 	template<typename I>
 	concept ResultInfoType = requires(I info) { info.Describe(); };
 
+	template<typename I>
+	concept ResultSourceType = requires(I info) { info.source; info.line; };
+
+	struct ResultStatistic
+	{
+		ResultStatistic() = default;
+
+		Result result;
+		const char* source = nullptr;
+		u64 line = 0;
+		u64 count = 0;
+		TimeStamp first;
+		TimeStamp last;
+		// message and description of the first occurrence, cut to ResultStatistics::max_sample_size characters
+		utf16_string message;
+		utf16_string info;
+	};
+
+	/*
+		Bounded summary of the results a thread pushed, used instead of its ResultQueue when the handler aggregates.
+		Results are keyed by their type, severity, source and line, every key keeps a count, the first and last time it occurred and one sample.
+		Once max_sites keys are in use, results with a new key are only counted as overflow.
+	*/
+	class ResultStatistics
+	{
+	public:
+		static constexpr size_t max_sites = 256;
+		static constexpr size_t max_sample_size = 256;
+
+		ResultStatistics() = default;
+		ResultStatistics(const ResultStatistics&) = delete;
+		ResultStatistics(ResultStatistics&& rhs) noexcept;
+
+		ResultStatistics& operator= (const ResultStatistics&) = delete;
+		ResultStatistics& operator= (ResultStatistics&& rhs) noexcept;
+
+		// The info is only described for the first occurrence of a key
+		template<typename I>
+		void Add(Result result, utf16_string&& message, const I& info)
+		{
+			const char* source = nullptr;
+			u64 line = 0;
+			if constexpr (ResultSourceType<I>)
+			{
+				source = info.source;
+				line = info.line;
+			}
+
+			std::lock_guard guard(mutex);
+			ResultStatistic* statistic = Find(result, source, line);
+			if (statistic && statistic->count == 1)
+			{
+				statistic->message = Sample(std::move(message));
+				if constexpr (ResultInfoType<I>)
+					statistic->info = Sample(info.Describe());
+			}
+		}
+		void Add(Result result, utf16_string&& message);
+
+		std::vector<ResultStatistic> Snapshot() const;
+		// Results that weren't recorded because every key was in use
+		u64 Overflow() const;
+		void Clear();
+
+	private:
+		struct Key
+		{
+			u32 result;
+			Severity severity;
+			const char* source;
+			u64 line;
+
+			bool operator== (const Key& rhs) const = default;
+		};
+
+		struct KeyHash
+		{
+			size_t operator() (const Key& key) const { return rv::hash(key.result, (u32)key.severity, reinterpret_cast<uintptr_t>(key.source), key.line); }
+		};
+
+		// Counts the occurrence, returns nullptr if the key didn't fit
+		ResultStatistic* Find(Result result, const char* source, u64 line);
+		static utf16_string Sample(utf16_string&& text);
+
+	private:
+		std::unordered_map<Key, ResultStatistic, KeyHash> statistics;
+		u64 overflow = 0;
+		mutable std::mutex mutex;
+	};
+
+	/*
+		Results pushed by a thread.
+		Every severity has its own list, so taking the results of some severities never skips over the others.
+		A result with several severity bits is filed under the highest one only.
+	*/
 	class ResultQueue
 	{
 	public:
@@ -35,6 +135,8 @@ namespace rv
 			Result result;
 			utf16_string message;
 			utf16_string info;
+			// push order across the severity lists
+			u64 sequence = 0;
 		};
 
 		template<typename I>
@@ -43,9 +145,10 @@ namespace rv
 			ResultInfo r;
 			r.message = std::move(message);
 			r.result = result;
+			r.sequence = sequence++;
 			if constexpr (ResultInfoType<I>)
 				r.info = info.Describe();
-			queue.PushEntry(std::move(r), info);
+			queues[SeverityIndex(result.severity())].PushEntry(std::move(r), info);
 		}
 		template<typename I>
 		void PushResult(Result result, utf16_string&& message, I&& info)
@@ -53,17 +156,30 @@ namespace rv
 			ResultInfo r;
 			r.message = std::move(message);
 			r.result = result;
+			r.sequence = sequence++;
 			if constexpr (ResultInfoType<I>)
 				r.info = info.Describe();
-			queue.PushEntry(std::move(r), std::move(info));
+			queues[SeverityIndex(result.severity())].PushEntry(std::move(r), std::move(info));
 		}
 
 		void PushResult(Result result, utf16_string&& message);
 
+		// Takes the oldest result of the given severities. Results are matched on their highest severity,
+		// e.g. a WARNING | ERROR result is returned when ERROR is requested but not for WARNING alone
 		Queue<ResultInfo>::Header* GetResult(Flags<Severity> severity = RV_SEVERITY_ALL);
 
+		ResultStatistics& Statistics();
+
 	private:
-		Queue<ResultInfo> queue;
+		static constexpr size_t severity_count = 3;
+
+		// Results without a severity are listed with the infos, combined severities with the most severe one
+		static size_t SeverityIndex(Severity severity);
+
+	private:
+		Queue<ResultInfo> queues[severity_count];
+		u64 sequence = 0;
+		ResultStatistics statistics;
 
 		friend struct ResultInfo;
 	};
@@ -95,7 +211,7 @@ namespace rv
 		const utf16_string& description() const;
 
 		template<typename I>
-		bool is_type() const { return header ? (header->type == typeid(I).hash_code()) : false; }
+		bool is_type() const { return header ? (header->type == type_id<I>()) : false; }
 
 		template<typename I>
 		I& info() { return *header->data<I>(); }
@@ -109,16 +225,41 @@ namespace rv
 	class ResultHandler
 	{
 	public:
+		ResultHandler();
+
+		// Only needed for result types created at runtime, the engine's own are in a table built at compile time
 		void RegisterResult(const Identifier32& result);
-		const char* GetResultName(const Result& result);
+		// Doesn't lock, returns nullptr for unknown results
+		const char* GetResultName(const Result& result) const;
 
+		// The calling thread's queue, looked up once per thread and cached
 		ResultQueue& GetThreadQueue();
 		std::vector<std::reference_wrapper<std::pair<const std::thread::id, ResultQueue>>> GetQueues();
 
-		template<typename I> void PushResult(Result result, utf16_string&& message, const I& info)	{ GetThreadQueue().PushResult(result, std::move(message), info); }
-		template<typename I> void PushResult(Result result, utf16_string&& message, I&& info)		{ GetThreadQueue().PushResult(result, std::move(message), std::move(info)); }
+		template<typename I>
+		void PushResult(Result result, utf16_string&& message, const I& info)
+		{
+			if (Aggregating())
+				GetThreadQueue().Statistics().Add(result, std::move(message), info);
+			else
+				GetThreadQueue().PushResult(result, std::move(message), info);
+		}
+		template<typename I>
+		void PushResult(Result result, utf16_string&& message, I&& info)
+		{
+			if (Aggregating())
+				GetThreadQueue().Statistics().Add(result, std::move(message), info);
+			else
+				GetThreadQueue().PushResult(result, std::move(message), std::move(info));
+		}
+
+		void PushResult(Result result, utf16_string&& message);
 
-		void PushResult(Result result, utf16_string&& message) { GetThreadQueue().PushResult(result, std::move(message)); }
+		// Results are summarized per call site in bounded statistics instead of queued one by one
+		void SetAggregation(bool aggregate);
+		bool Aggregating() const;
+		// Writes the statistics of every thread, returns the highest severity among them
+		Severity DumpStatistics(std::wostream& ss);
 
 		void Clear();
 
@@ -128,31 +269,51 @@ namespace rv
 		static constexpr bool enabled = false;
 #		endif
 
+		static constexpr size_t max_result_names = 256;
+
 	private:
-		std::map<u32, const char*> nameMap;
-		std::mutex nameMutex;
+		// open addressing table that is only ever inserted into, a slot's key is claimed before its name is published
+		std::atomic<u32> nameKeys[max_result_names];
+		std::atomic<const char*> names[max_result_names];
 
 		std::map<std::thread::id, ResultQueue> queueMap;
 		std::mutex queueMutex;
+		// unique across handlers and renewed by Clear, threads compare it to know their cached queue is still valid
+		std::atomic<u64> generation;
+		std::atomic<bool> aggregate = false;
 	};
 
+	/*
+		Throwing only stores the result, its name and the message, the text is formatted when what or wide_what is first called and then cached.
+		Exceptions that are caught and dropped never format anything. The cache is filled once, so the text can be read from several threads.
+	*/
 	class ResultException : public std::exception
 	{
 	public:
 		ResultException() = default;
 		ResultException(const Result& result);
 		ResultException(const Result& result, const utf16_string& message);
+		ResultException(const Result& result, utf16_string&& message);
+		ResultException(const ResultException& rhs);
+
+		// the cache can only be filled once
+		ResultException& operator= (const ResultException&) = delete;
 
 		const char* what() const override;
 		const wchar_t* wide_what() const;
 		const Result& result() const;
 
 	private:
-		void Format(std::wostringstream& ss);
+		void Format() const;
 
 		Result m_result;
-		utf8_string m_message_8;
-		utf16_string m_message_16;		
+		// looked up when thrown, result types registered at runtime are gone once the handler is cleared
+		const char* m_name = nullptr;
+		utf16_string m_message;
+		mutable std::once_flag m_format;
+		mutable std::atomic<bool> m_formatted = false;
+		mutable utf8_string m_what_8;
+		mutable utf16_string m_what_16;
 	};
 
 	extern ResultHandler resultHandler;
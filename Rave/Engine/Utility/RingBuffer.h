@@ -0,0 +1,121 @@
+#pragma once
+#include "Engine/Utility/Types.h"
+#include <atomic>
+#include <new>
+#include <utility>
+
+namespace rv
+{
+	/*
+		Bounded lock-free multi-producer / multi-consumer ring buffer.
+		Every cell carries a sequence number that tells producers and consumers whose turn it is,
+		so pushing and popping claim a cell with a single compare exchange and never wait on each other.
+		A full ring rejects pushes instead of blocking, which bounds the time a producer can spend in TryPush.
+	*/
+	template<typename T, size_t capacity>
+	class RingBuffer
+	{
+		static_assert(capacity >= 2 && (capacity & (capacity - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+	public:
+		RingBuffer()
+		{
+			for (size_t i = 0; i < capacity; ++i)
+				cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		RingBuffer(const RingBuffer&) = delete;
+		~RingBuffer()
+		{
+			for (size_t pos = popPosition.load(std::memory_order_relaxed); pos != pushPosition.load(std::memory_order_relaxed); ++pos)
+				cells[pos & mask].value()->~T();
+		}
+
+		RingBuffer& operator= (const RingBuffer&) = delete;
+
+		// Returns false if the ring is full. Can be called from any thread
+		template<typename... Args>
+		bool TryPush(Args&&... args)
+		{
+			size_t pos = pushPosition.load(std::memory_order_relaxed);
+			Cell* cell;
+			while (true)
+			{
+				cell = &cells[pos & mask];
+				const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				const intptr_t difference = (intptr_t)sequence - (intptr_t)pos;
+				if (difference == 0)
+				{
+					if (pushPosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (difference < 0)
+					return false;
+				else
+					pos = pushPosition.load(std::memory_order_relaxed);
+			}
+
+			new (cell->storage) T(std::forward<Args>(args)...);
+			cell->sequence.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Returns false if the ring is empty. Can be called from any thread
+		bool TryPop(T& out)
+		{
+			size_t pos = popPosition.load(std::memory_order_relaxed);
+			Cell* cell;
+			while (true)
+			{
+				cell = &cells[pos & mask];
+				const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				const intptr_t difference = (intptr_t)sequence - (intptr_t)(pos + 1);
+				if (difference == 0)
+				{
+					if (popPosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (difference < 0)
+					return false;
+				else
+					pos = popPosition.load(std::memory_order_relaxed);
+			}
+
+			out = std::move(*cell->value());
+			cell->value()->~T();
+			cell->sequence.store(pos + capacity, std::memory_order_release);
+			return true;
+		}
+
+		// True if the next pop would succeed. Can be called from any thread
+		bool Ready() const
+		{
+			const size_t pos = popPosition.load(std::memory_order_relaxed);
+			return cells[pos & mask].sequence.load(std::memory_order_acquire) == pos + 1;
+		}
+
+		// Amount of pushes so far, a consumer that popped as many items has seen every push that completed before this call
+		size_t PushCount() const
+		{
+			return pushPosition.load(std::memory_order_acquire);
+		}
+
+		static constexpr size_t Capacity() { return capacity; }
+
+	private:
+		static constexpr size_t mask = capacity - 1;
+
+		struct Cell
+		{
+			T* value() { return std::launder(reinterpret_cast<T*>(storage)); }
+
+			std::atomic<size_t> sequence;
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+
+	private:
+		Cell cells[capacity];
+		// producers and consumers update their position on separate cache lines
+		alignas(64) std::atomic<size_t> pushPosition = 0;
+		alignas(64) std::atomic<size_t> popPosition = 0;
+	};
+}
\ No newline at end of file
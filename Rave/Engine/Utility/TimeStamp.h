@@ -18,10 +18,35 @@ namespace rv
 		const std::chrono::time_zone* m_zone;
 	};
 
+	/*
+		Point in time, stored as raw steady clock ticks so capturing one costs a single clock read.
+		The local date and time are only broken down when they are queried, through a wall clock calibration and UTC offset
+		that are cached and refreshed every calibration_period instead of looking up the time zone per stamp.
+		The cached offset is only used for stamps inside the period it is valid for, stamps from before a daylight saving change
+		look their offset up in the time zone, so they keep the hour they were taken at.
+	*/
 	class TimeStamp
 	{
 	public:
-		TimeStamp(const TimeZone& zone = TimeZone());
+		static constexpr std::chrono::seconds calibration_period = 60s;
+
+		struct Breakdown
+		{
+					 int year;
+			unsigned int month;
+			unsigned int day;
+					 int hours;
+					 int minutes;
+			   long long seconds;
+			   long long milliseconds;
+		};
+
+		TimeStamp();
+		// Breaks down in the given zone instead of the cached local offset
+		TimeStamp(const TimeZone& zone);
+
+		// Breaks the stamp down once, every field comes from the same calibration
+		Breakdown breakdown() const;
 
 				 int year() const;
 		unsigned int month() const;
@@ -31,11 +56,18 @@ namespace rv
 		   long long seconds() const;
 		   long long milliseconds() const;
 
-		void Reset(const TimeZone& zone = TimeZone());
+		std::chrono::steady_clock::time_point ticks() const;
+		std::chrono::system_clock::time_point time() const;
+
+		void Reset();
+		void Reset(const TimeZone& zone);
 
 	private:
-		std::chrono::year_month_day ymd;
-		std::chrono::hh_mm_ss<std::chrono::milliseconds> hms;
+		std::chrono::local_time<std::chrono::milliseconds> local() const;
+
+	private:
+		std::chrono::steady_clock::rep m_ticks;
+		const std::chrono::time_zone* m_zone;
 	};
 }
 
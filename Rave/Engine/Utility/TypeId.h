@@ -0,0 +1,33 @@
+#pragma once
+#include "Engine/Utility/Types.h"
+#include "Engine/Utility/Hash.h"
+#include <string_view>
+
+namespace rv
+{
+	namespace detail
+	{
+		// The signature names the type, it differs between compilers but is the same for every translation unit
+		template<typename T>
+		static constexpr std::string_view type_signature()
+		{
+#ifdef _MSC_VER
+			return __FUNCSIG__;
+#else
+			return __PRETTY_FUNCTION__;
+#endif
+		}
+	}
+
+	/*
+		Identifies a type without RTTI, the id is a hash of a signature naming the type.
+		The id is a compile time constant, qualifiers are part of the type.
+		It has 64 bits on every platform, a 32 bit id would make collisions between the types of a program likely.
+	*/
+	template<typename T>
+	static constexpr u64 type_id()
+	{
+		constexpr u64 id = hash<u64>(detail::type_signature<T>());
+		return id;
+	}
+}
\ No newline at end of file
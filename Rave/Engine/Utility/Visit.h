@@ -0,0 +1,206 @@
+#pragma once
+#include "Engine/Utility/Types.h"
+#include "Engine/Utility/TypeId.h"
+#include "Engine/Utility/Queue.h"
+#include <array>
+#include <bit>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace rv
+{
+	// Combines lambdas into one visitor, e.g. Overloads{ [](const A&) {}, [](const B&) {} }
+	template<typename... Fs>
+	struct Overloads : Fs... { using Fs::operator()...; };
+	template<typename... Fs>
+	Overloads(Fs...) -> Overloads<Fs...>;
+
+	namespace detail
+	{
+		// Values are either queue headers or wrappers like Event, LogEvent and Any that expose Type() and Get<T>()
+		template<typename V>
+		concept VisitHeader = requires(V& value) { value.type; value.template data<void>(); };
+
+		template<typename V>
+		concept VisitQueue = requires(V& queue) { queue.PeekHeader()->next; };
+
+		template<typename V>
+		static u64 visit_type(const V& value)
+		{
+			if constexpr (VisitHeader<V>)
+				return value.type;
+			else
+				return value.Type();
+		}
+
+		template<typename T, typename V>
+		static decltype(auto) visit_get(V& value)
+		{
+			if constexpr (VisitHeader<V>)
+				return *value.template data<T>();
+			else
+				return value.template Get<T>();
+		}
+
+		struct VisitLayout
+		{
+			size_t size = 0;
+			u32 shift = 0;
+		};
+
+		struct VisitSlot
+		{
+			u64 type = 0;
+			size_t index = 0;
+		};
+
+		// Finds the smallest power of two table and a shift of the type ids that gives every id its own slot
+		template<size_t N>
+		static constexpr VisitLayout visit_layout(const std::array<u64, N>& types)
+		{
+			for (size_t size = std::bit_ceil(N); size <= std::bit_ceil(N) * 64; size *= 2)
+				for (u32 shift = 0; shift + std::bit_width(size - 1) <= sizeof(u64) * 8; ++shift)
+				{
+					bool distinct = true;
+					for (size_t i = 0; i < N && distinct; ++i)
+						for (size_t j = i + 1; j < N && distinct; ++j)
+							distinct = ((types[i] >> shift) & (size - 1)) != ((types[j] >> shift) & (size - 1));
+					if (distinct)
+						return { size, shift };
+				}
+			return {};
+		}
+
+		// Empty slots map to N, the index of no type
+		template<size_t S, size_t N>
+		static constexpr std::array<VisitSlot, S> visit_slots(const std::array<u64, N>& types, VisitLayout layout)
+		{
+			std::array<VisitSlot, S> slots{};
+			for (VisitSlot& slot : slots)
+				slot.index = N;
+			for (size_t i = 0; i < N; ++i)
+				slots[(types[i] >> layout.shift) & (S - 1)] = { types[i], i };
+			return slots;
+		}
+	}
+
+	/*
+		Maps the type id of a value to the index of its type in Ts with a single table lookup.
+		The table and the shift that makes the ids collision free are computed at compile time.
+	*/
+	template<typename... Ts>
+	class VisitTable
+	{
+	public:
+		static constexpr size_t count = sizeof...(Ts);
+		static constexpr size_t npos = count;
+
+		// The index of the type in Ts, npos if it isn't one of them
+		static constexpr size_t Index(u64 type)
+		{
+			const detail::VisitSlot& slot = slots[(type >> layout.shift) & (layout.size - 1)];
+			return slot.type == type ? slot.index : npos;
+		}
+
+	private:
+		static_assert(count > 0, "Visit needs at least one type");
+
+		static constexpr std::array<u64, count> types = { type_id<Ts>()... };
+		static constexpr detail::VisitLayout layout = detail::visit_layout(types);
+		static_assert(layout.size != 0, "Visited types have to be distinct");
+		static constexpr std::array<detail::VisitSlot, layout.size> slots = detail::visit_slots<layout.size>(types, layout);
+	};
+
+	namespace detail
+	{
+		template<typename T, typename V, typename F>
+		static void visit_call(V& value, F& visitor)
+		{
+			visitor(visit_get<T>(value));
+		}
+
+		template<typename... Ts, typename V, typename F>
+		static bool visit_value(V& value, F& visitor)
+		{
+			using Handler = void(*)(V&, F&);
+			static constexpr Handler handlers[] = { &visit_call<Ts, V, F>... };
+
+			const size_t index = VisitTable<Ts...>::Index(visit_type(value));
+			if (index == VisitTable<Ts...>::npos)
+				return false;
+			handlers[index](value, visitor);
+			return true;
+		}
+
+		// Visits the count elements of the batch whose type has the index in the table, stops after the last one
+		template<typename T, typename Table, typename R, typename F>
+		static void visit_group(R& batch, size_t index, size_t count, F& visitor)
+		{
+			for (size_t i = 0; count > 0; ++i)
+				if (Table::Index(visit_type(batch[i])) == index)
+				{
+					visitor(visit_get<T>(batch[i]));
+					--count;
+				}
+		}
+	}
+
+	/*
+		Calls the overload matching the type of the value's data, if it's one of Ts, e.g.
+		Visit<ResizeEvent, FailedResult>(event, [](const ResizeEvent& e) {}, [](const FailedResult& e) {});
+		Returns true if an overload was called.
+	*/
+	template<typename... Ts, typename V, typename... Fs>
+	requires (!detail::VisitQueue<V>)
+	bool Visit(V& value, Fs&&... overloads)
+	{
+		Overloads visitor{ std::forward<Fs>(overloads)... };
+		return detail::visit_value<Ts...>(value, visitor);
+	}
+
+	// Visits every entry of the queue in order without removing them, returns the amount of entries visited
+	template<typename... Ts, typename I, BlockAllocator A, typename... Fs>
+	size_t Visit(Queue<I, A>& queue, Fs&&... overloads)
+	{
+		Overloads visitor{ std::forward<Fs>(overloads)... };
+		size_t visited = 0;
+		for (typename Queue<I, A>::Header* header = queue.PeekHeader(); header; header = header->next)
+			visited += detail::visit_value<Ts...>(*header, visitor);
+		return visited;
+	}
+
+	/*
+		Visits a batch, e.g. the events DrainEvents appended, grouped by type.
+		Every element of the first type in Ts is visited, then every element of the second type, and so on,
+		so each overload runs over its whole group at once. Elements of the same type keep their order, elements of other types are skipped.
+		Returns the amount of elements visited.
+	*/
+	template<typename... Ts, typename R, typename... Fs>
+	size_t ForEach(R&& batch, Fs&&... overloads)
+	{
+		using Table = VisitTable<Ts...>;
+		Overloads visitor{ std::forward<Fs>(overloads)... };
+
+		// every group scans the batch up to its last element, counting first skips empty groups and doesn't need any memory besides the counts
+		const size_t size = std::size(batch);
+		std::array<size_t, Table::count> counts{};
+		size_t visited = 0;
+		for (size_t i = 0; i < size; ++i)
+		{
+			const size_t index = Table::Index(detail::visit_type(batch[i]));
+			if (index != Table::npos)
+			{
+				++counts[index];
+				++visited;
+			}
+		}
+
+		[&]<size_t... K>(std::index_sequence<K...>)
+		{
+			(detail::visit_group<Ts, Table>(batch, K, counts[K], visitor), ...);
+		}(std::index_sequence_for<Ts...>{});
+
+		return visited;
+	}
+}
\ No newline at end of file
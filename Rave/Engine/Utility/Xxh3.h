@@ -0,0 +1,412 @@
+#pragma once
+#include "Engine/Utility/Types.h"
+#include <array>
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace rv
+{
+	struct Hash128
+	{
+		u64 low = 0;
+		u64 high = 0;
+
+		constexpr bool operator==(const Hash128&) const = default;
+	};
+
+	namespace detail
+	{
+		/*
+			The bytes of a contiguous range of trivially copyable values, in the machine's byte order.
+			Reads are plain loads at run time, during constant evaluation the bytes are taken from the values one by one.
+		*/
+		template<typename T>
+		struct HashInput
+		{
+			constexpr u8 Byte(size_t offset) const
+			{
+				if (std::is_constant_evaluated())
+					return std::bit_cast<std::array<u8, sizeof(T)>>(data[offset / sizeof(T)])[offset % sizeof(T)];
+				return reinterpret_cast<const u8*>(data)[offset];
+			}
+
+			constexpr u32 Read32(size_t offset) const
+			{
+				if (std::is_constant_evaluated())
+					return (u32)Byte(offset) | ((u32)Byte(offset + 1) << 8) | ((u32)Byte(offset + 2) << 16) | ((u32)Byte(offset + 3) << 24);
+				u32 value;
+				std::memcpy(&value, reinterpret_cast<const u8*>(data) + offset, sizeof(value));
+				return value;
+			}
+
+			constexpr u64 Read64(size_t offset) const
+			{
+				if (std::is_constant_evaluated())
+					return (u64)Read32(offset) | ((u64)Read32(offset + 4) << 32);
+				u64 value;
+				std::memcpy(&value, reinterpret_cast<const u8*>(data) + offset, sizeof(value));
+				return value;
+			}
+
+			const T* data;
+			// in bytes
+			size_t size;
+		};
+
+		/*
+			XXH3 0.8 with the default secret and seed, the 64 and 128 bit results match the reference implementation.
+			Inputs up to 240 bytes are hashed here, longer inputs are folded into 8 accumulators one 64 byte stripe at a time.
+			At run time the stripes are handled by the vectorised xxh3_accumulate_stripes and xxh3_scramble_accumulators.
+		*/
+		namespace xxh3
+		{
+			static constexpr u32 prime32_1 = 0x9E3779B1;
+			static constexpr u32 prime32_2 = 0x85EBCA77;
+			static constexpr u32 prime32_3 = 0xC2B2AE3D;
+			static constexpr u64 prime64_1 = 0x9E3779B185EBCA87;
+			static constexpr u64 prime64_2 = 0xC2B2AE3D27D4EB4F;
+			static constexpr u64 prime64_3 = 0x165667B19E3779F9;
+			static constexpr u64 prime64_4 = 0x85EBCA77C2B2AE63;
+			static constexpr u64 prime64_5 = 0x27D4EB2F165667C5;
+			static constexpr u64 prime_mx1 = 0x165667919E3779F9;
+			static constexpr u64 prime_mx2 = 0x9FB21C651E98DF25;
+
+			static constexpr size_t stripe_size = 64;
+			static constexpr size_t accumulator_count = 8;
+			static constexpr size_t secret_size = 192;
+			static constexpr size_t secret_consume_rate = 8;
+			static constexpr size_t stripes_per_block = (secret_size - stripe_size) / secret_consume_rate;
+			static constexpr size_t block_size = stripe_size * stripes_per_block;
+			static constexpr size_t midsize_max = 240;
+
+			alignas(64) static constexpr u8 secret_bytes[secret_size] = {
+				0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+				0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+				0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+				0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+				0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+				0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+				0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+				0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+				0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+				0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+				0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+				0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+			};
+			static constexpr HashInput<u8> secret = { secret_bytes, secret_size };
+
+			static constexpr u64 initial_accumulators[accumulator_count] = { prime32_3, prime64_1, prime64_2, prime64_3, prime64_4, prime32_2, prime64_5, prime32_1 };
+
+			static constexpr u32 swap32(u32 x)
+			{
+				return ((x << 24) & 0xFF000000) | ((x << 8) & 0x00FF0000) | ((x >> 8) & 0x0000FF00) | ((x >> 24) & 0x000000FF);
+			}
+
+			static constexpr u64 swap64(u64 x)
+			{
+				return ((u64)swap32((u32)x) << 32) | swap32((u32)(x >> 32));
+			}
+
+			static constexpr Hash128 multiply(u64 lhs, u64 rhs)
+			{
+#if defined(__SIZEOF_INT128__)
+				const unsigned __int128 product = (unsigned __int128)lhs * rhs;
+				return { (u64)product, (u64)(product >> 64) };
+#else
+#	if defined(_MSC_VER) && defined(_M_X64)
+				if (!std::is_constant_evaluated())
+				{
+					Hash128 product;
+					product.low = _umul128(lhs, rhs, &product.high);
+					return product;
+				}
+#	endif
+				const u64 lo_lo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+				const u64 hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+				const u64 lo_hi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+				const u64 hi_hi = (lhs >> 32) * (rhs >> 32);
+				const u64 cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+				return { (cross << 32) | (lo_lo & 0xFFFFFFFF), (hi_lo >> 32) + (cross >> 32) + hi_hi };
+#endif
+			}
+
+			static constexpr u64 multiply_fold(u64 lhs, u64 rhs)
+			{
+				const Hash128 product = multiply(lhs, rhs);
+				return product.low ^ product.high;
+			}
+
+			static constexpr u64 xxh64_avalanche(u64 h)
+			{
+				h ^= h >> 33;
+				h *= prime64_2;
+				h ^= h >> 29;
+				h *= prime64_3;
+				return h ^ (h >> 32);
+			}
+
+			static constexpr u64 avalanche(u64 h)
+			{
+				h ^= h >> 37;
+				h *= prime_mx1;
+				return h ^ (h >> 32);
+			}
+
+			static constexpr u64 rrmxmx(u64 h, u64 length)
+			{
+				h ^= std::rotl(h, 49) ^ std::rotl(h, 24);
+				h *= prime_mx2;
+				h ^= (h >> 35) + length;
+				h *= prime_mx2;
+				return h ^ (h >> 28);
+			}
+
+			template<typename T>
+			static constexpr u64 mix16(const HashInput<T>& input, size_t offset, size_t secretOffset)
+			{
+				return multiply_fold(input.Read64(offset) ^ secret.Read64(secretOffset), input.Read64(offset + 8) ^ secret.Read64(secretOffset + 8));
+			}
+
+			template<typename T>
+			static constexpr Hash128 mix32(Hash128 acc, const HashInput<T>& input, size_t offset1, size_t offset2, size_t secretOffset)
+			{
+				acc.low += mix16(input, offset1, secretOffset);
+				acc.low ^= input.Read64(offset2) + input.Read64(offset2 + 8);
+				acc.high += mix16(input, offset2, secretOffset + 16);
+				acc.high ^= input.Read64(offset1) + input.Read64(offset1 + 8);
+				return acc;
+			}
+
+			template<typename T>
+			static constexpr u32 combine_1to3(const HashInput<T>& input)
+			{
+				const size_t length = input.size;
+				return ((u32)input.Byte(0) << 16) | ((u32)input.Byte(length >> 1) << 24) | (u32)input.Byte(length - 1) | ((u32)length << 8);
+			}
+
+			template<typename T>
+			static constexpr void accumulate_512(u64* acc, const HashInput<T>& input, size_t offset, size_t secretOffset)
+			{
+				for (size_t i = 0; i < accumulator_count; ++i)
+				{
+					const u64 value = input.Read64(offset + 8 * i);
+					const u64 key = value ^ secret.Read64(secretOffset + 8 * i);
+					acc[i ^ 1] += value;
+					acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+				}
+			}
+
+			static constexpr void scramble_scalar(u64* acc)
+			{
+				for (size_t i = 0; i < accumulator_count; ++i)
+				{
+					u64 value = acc[i];
+					value ^= value >> 47;
+					value ^= secret.Read64(secret_size - stripe_size + 8 * i);
+					acc[i] = value * prime32_1;
+				}
+			}
+		}
+
+		// Run time versions of the long input loops, vectorised where the target allows it
+		void xxh3_accumulate_stripes(u64* acc, const u8* input, size_t stripes, size_t secretOffset);
+		void xxh3_scramble_accumulators(u64* acc);
+
+		namespace xxh3
+		{
+			template<typename T>
+			static constexpr void accumulate(u64* acc, const HashInput<T>& input, size_t offset, size_t stripes, size_t secretOffset)
+			{
+				if (!std::is_constant_evaluated())
+					return xxh3_accumulate_stripes(acc, reinterpret_cast<const u8*>(input.data) + offset, stripes, secretOffset);
+				for (size_t i = 0; i < stripes; ++i)
+					accumulate_512(acc, input, offset + i * stripe_size, secretOffset + i * secret_consume_rate);
+			}
+
+			static constexpr void scramble(u64* acc)
+			{
+				if (!std::is_constant_evaluated())
+					return xxh3_scramble_accumulators(acc);
+				scramble_scalar(acc);
+			}
+
+			// Folds every stripe of an input longer than midsize_max into the accumulators
+			template<typename T>
+			static constexpr void accumulate_long(u64* acc, const HashInput<T>& input)
+			{
+				const size_t blocks = (input.size - 1) / block_size;
+				for (size_t block = 0; block < blocks; ++block)
+				{
+					accumulate(acc, input, block * block_size, stripes_per_block, 0);
+					scramble(acc);
+				}
+
+				const size_t stripes = ((input.size - 1) - block_size * blocks) / stripe_size;
+				accumulate(acc, input, blocks * block_size, stripes, 0);
+				// the last stripe overlaps the previous ones if the input isn't a multiple of the stripe size
+				accumulate_512(acc, input, input.size - stripe_size, secret_size - stripe_size - 7);
+			}
+
+			static constexpr u64 merge(const u64* acc, size_t secretOffset, u64 start)
+			{
+				u64 result = start;
+				for (size_t i = 0; i < accumulator_count / 2; ++i)
+					result += multiply_fold(acc[2 * i] ^ secret.Read64(secretOffset + 16 * i), acc[2 * i + 1] ^ secret.Read64(secretOffset + 16 * i + 8));
+				return avalanche(result);
+			}
+
+			static constexpr u64 digest_long_64(const u64* acc, u64 length)
+			{
+				return merge(acc, 11, length * prime64_1);
+			}
+
+			static constexpr Hash128 digest_long_128(const u64* acc, u64 length)
+			{
+				return { merge(acc, 11, length * prime64_1), merge(acc, secret_size - stripe_size - 11, ~(length * prime64_2)) };
+			}
+
+			template<typename T>
+			static constexpr u64 hash_64(const HashInput<T>& input)
+			{
+				const size_t length = input.size;
+				if (length == 0)
+					return xxh64_avalanche(secret.Read64(56) ^ secret.Read64(64));
+				if (length <= 3)
+					return xxh64_avalanche(combine_1to3(input) ^ (u64)(secret.Read32(0) ^ secret.Read32(4)));
+				if (length <= 8)
+				{
+					const u64 value = input.Read32(length - 4) + ((u64)input.Read32(0) << 32);
+					return rrmxmx(value ^ (secret.Read64(8) ^ secret.Read64(16)), length);
+				}
+				if (length <= 16)
+				{
+					const u64 low = input.Read64(0) ^ (secret.Read64(24) ^ secret.Read64(32));
+					const u64 high = input.Read64(length - 8) ^ (secret.Read64(40) ^ secret.Read64(48));
+					return avalanche(length + swap64(low) + high + multiply_fold(low, high));
+				}
+				if (length <= 128)
+				{
+					u64 acc = length * prime64_1;
+					if (length > 32)
+					{
+						if (length > 64)
+						{
+							if (length > 96)
+							{
+								acc += mix16(input, 48, 96);
+								acc += mix16(input, length - 64, 112);
+							}
+							acc += mix16(input, 32, 64);
+							acc += mix16(input, length - 48, 80);
+						}
+						acc += mix16(input, 16, 32);
+						acc += mix16(input, length - 32, 48);
+					}
+					acc += mix16(input, 0, 0);
+					acc += mix16(input, length - 16, 16);
+					return avalanche(acc);
+				}
+				if (length <= midsize_max)
+				{
+					u64 acc = length * prime64_1;
+					for (size_t i = 0; i < 8; ++i)
+						acc += mix16(input, 16 * i, 16 * i);
+					acc = avalanche(acc);
+					u64 end = mix16(input, length - 16, 136 - 17);
+					for (size_t i = 8; i < length / 16; ++i)
+						end += mix16(input, 16 * i, 16 * (i - 8) + 3);
+					return avalanche(acc + end);
+				}
+
+				u64 acc[accumulator_count];
+				for (size_t i = 0; i < accumulator_count; ++i)
+					acc[i] = initial_accumulators[i];
+				accumulate_long(acc, input);
+				return digest_long_64(acc, length);
+			}
+
+			template<typename T>
+			static constexpr Hash128 hash_128(const HashInput<T>& input)
+			{
+				const size_t length = input.size;
+				if (length == 0)
+					return { xxh64_avalanche(secret.Read64(64) ^ secret.Read64(72)), xxh64_avalanche(secret.Read64(80) ^ secret.Read64(88)) };
+				if (length <= 3)
+				{
+					const u32 low = combine_1to3(input);
+					const u32 high = std::rotl(swap32(low), 13);
+					return {
+						xxh64_avalanche(low ^ (u64)(secret.Read32(0) ^ secret.Read32(4))),
+						xxh64_avalanche(high ^ (u64)(secret.Read32(8) ^ secret.Read32(12)))
+					};
+				}
+				if (length <= 8)
+				{
+					const u64 value = input.Read32(0) + ((u64)input.Read32(length - 4) << 32);
+					Hash128 m = multiply(value ^ (secret.Read64(16) ^ secret.Read64(24)), prime64_1 + (length << 2));
+					m.high += m.low << 1;
+					m.low ^= m.high >> 3;
+					m.low ^= m.low >> 35;
+					m.low *= prime_mx2;
+					m.low ^= m.low >> 28;
+					m.high = avalanche(m.high);
+					return m;
+				}
+				if (length <= 16)
+				{
+					const u64 low = input.Read64(0);
+					const u64 high = input.Read64(length - 8) ^ (secret.Read64(48) ^ secret.Read64(56));
+					Hash128 m = multiply(low ^ input.Read64(length - 8) ^ (secret.Read64(32) ^ secret.Read64(40)), prime64_1);
+					m.low += (u64)(length - 1) << 54;
+					m.high += high + (high & 0xFFFFFFFF) * (prime32_2 - 1);
+					m.low ^= swap64(m.high);
+					Hash128 h = multiply(m.low, prime64_2);
+					h.high += m.high * prime64_2;
+					return { avalanche(h.low), avalanche(h.high) };
+				}
+
+				Hash128 acc = { length * prime64_1, 0 };
+				if (length <= 128)
+				{
+					if (length > 32)
+					{
+						if (length > 64)
+						{
+							if (length > 96)
+								acc = mix32(acc, input, 48, length - 64, 96);
+							acc = mix32(acc, input, 32, length - 48, 64);
+						}
+						acc = mix32(acc, input, 16, length - 32, 32);
+					}
+					acc = mix32(acc, input, 0, length - 16, 0);
+				}
+				else if (length <= midsize_max)
+				{
+					for (size_t i = 0; i < 4; ++i)
+						acc = mix32(acc, input, 32 * i, 32 * i + 16, 32 * i);
+					acc = { avalanche(acc.low), avalanche(acc.high) };
+					for (size_t i = 4; i < length / 32; ++i)
+						acc = mix32(acc, input, 32 * i, 32 * i + 16, 3 + 32 * (i - 4));
+					acc = mix32(acc, input, length - 16, length - 32, 136 - 17 - 16);
+				}
+				else
+				{
+					u64 accumulators[accumulator_count];
+					for (size_t i = 0; i < accumulator_count; ++i)
+						accumulators[i] = initial_accumulators[i];
+					accumulate_long(accumulators, input);
+					return digest_long_128(accumulators, length);
+				}
+
+				const u64 low = acc.low + acc.high;
+				const u64 high = acc.low * prime64_1 + acc.high * prime64_4 + length * prime64_2;
+				return { avalanche(low), 0 - avalanche(high) };
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "Engine/Utility/Allocator.h"
+#include <algorithm>
+#include <bit>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	static constexpr size_t class_count = std::countr_zero(rv::SlabAllocator::max_block_size) - std::countr_zero(rv::SlabAllocator::min_block_size) + 1;
+
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	static constexpr size_t size_class(size_t size)
+	{
+		if (size <= rv::SlabAllocator::min_block_size)
+			return 0;
+		return std::bit_width(size - 1) - std::countr_zero(rv::SlabAllocator::min_block_size);
+	}
+
+	static constexpr size_t class_size(size_t sizeClass)
+	{
+		return rv::SlabAllocator::min_block_size << sizeClass;
+	}
+
+	// the amount of blocks moved between a thread cache and the shared pool at once
+	static constexpr size_t batch_size(size_t sizeClass)
+	{
+		return std::max<size_t>(8, 4096 / class_size(sizeClass));
+	}
+
+	struct SharedPool
+	{
+		struct Batch
+		{
+			FreeBlock* first;
+			size_t count;
+		};
+
+		std::mutex mutex;
+		std::vector<Batch> batches[class_count];
+	};
+
+	// The shared pool is never destroyed: blocks may still be freed by static objects during shutdown.
+	SharedPool& shared_pool()
+	{
+		static SharedPool* pool = new SharedPool();
+		return *pool;
+	}
+
+	// Trivially destructible so it stays usable after the thread's destructors have run.
+	struct ThreadCache
+	{
+		FreeBlock* free[class_count];
+		size_t count[class_count];
+		bool detached;
+	};
+
+	thread_local ThreadCache cache = {};
+
+	static void give_back(FreeBlock* first, size_t count, size_t sizeClass)
+	{
+		SharedPool& pool = shared_pool();
+		std::lock_guard guard(pool.mutex);
+		pool.batches[sizeClass].push_back({ first, count });
+	}
+
+	static FreeBlock* split(FreeBlock*& list, size_t count)
+	{
+		FreeBlock* first = list;
+		FreeBlock* last = list;
+		for (size_t i = 1; i < count; ++i)
+			last = last->next;
+		list = last->next;
+		last->next = nullptr;
+		return first;
+	}
+
+	struct ThreadCacheFlusher
+	{
+		~ThreadCacheFlusher()
+		{
+			for (size_t c = 0; c < class_count; ++c)
+				if (cache.free[c])
+					give_back(cache.free[c], cache.count[c], c);
+			cache = {};
+			cache.detached = true;
+		}
+	};
+
+	thread_local ThreadCacheFlusher flusher;
+
+	static void refill(size_t sizeClass)
+	{
+		// makes sure the cache is returned to the shared pool when this thread exits
+		(void)&flusher;
+
+		SharedPool& pool = shared_pool();
+		{
+			std::lock_guard guard(pool.mutex);
+			auto& batches = pool.batches[sizeClass];
+			if (!batches.empty())
+			{
+				cache.free[sizeClass] = batches.back().first;
+				cache.count[sizeClass] = batches.back().count;
+				batches.pop_back();
+				return;
+			}
+		}
+
+		const size_t size = class_size(sizeClass);
+		const size_t count = rv::SlabAllocator::chunk_size / size;
+		rv::byte* chunk = reinterpret_cast<rv::byte*>(::operator new(rv::SlabAllocator::chunk_size));
+		for (size_t i = 0; i < count - 1; ++i)
+			reinterpret_cast<FreeBlock*>(chunk + i * size)->next = reinterpret_cast<FreeBlock*>(chunk + (i + 1) * size);
+		reinterpret_cast<FreeBlock*>(chunk + (count - 1) * size)->next = nullptr;
+
+		cache.free[sizeClass] = reinterpret_cast<FreeBlock*>(chunk);
+		cache.count[sizeClass] = count;
+	}
+}
+
+void* rv::HeapAllocator::Allocate(size_t size, size_t alignment)
+{
+	if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		return ::operator new(size, std::align_val_t(alignment));
+	return ::operator new(size);
+}
+
+void rv::HeapAllocator::Free(void* block, size_t, size_t alignment)
+{
+	if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		::operator delete(block, std::align_val_t(alignment));
+	else
+		::operator delete(block);
+}
+
+void* rv::SlabAllocator::Allocate(size_t size, size_t alignment)
+{
+	if (!Pooled(size, alignment))
+		return HeapAllocator::Allocate(size, alignment);
+
+	const size_t sizeClass = size_class(size);
+	if (cache.detached)
+		// may end up in the shared pool once freed, so it has to span the whole size class
+		return ::operator new(class_size(sizeClass));
+
+	if (!cache.free[sizeClass])
+		refill(sizeClass);
+
+	FreeBlock* block = cache.free[sizeClass];
+	cache.free[sizeClass] = block->next;
+	--cache.count[sizeClass];
+	return block;
+}
+
+void rv::SlabAllocator::Free(void* block, size_t size, size_t alignment)
+{
+	if (!block)
+		return;
+	if (!Pooled(size, alignment))
+		return HeapAllocator::Free(block, size, alignment);
+
+	const size_t sizeClass = size_class(size);
+	FreeBlock* freed = reinterpret_cast<FreeBlock*>(block);
+
+	if (cache.detached)
+	{
+		freed->next = nullptr;
+		give_back(freed, 1, sizeClass);
+		return;
+	}
+
+	freed->next = cache.free[sizeClass];
+	cache.free[sizeClass] = freed;
+	++cache.count[sizeClass];
+
+	// blocks freed on a consumer thread flow back to the producers through the shared pool
+	const size_t batch = batch_size(sizeClass);
+	if (cache.count[sizeClass] >= 2 * batch)
+	{
+		give_back(split(cache.free[sizeClass], batch), batch, sizeClass);
+		cache.count[sizeClass] -= batch;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "Engine/Utility/AsyncLogWriter.h"
+#include "Engine/Utility/Logger.h"
+#include <algorithm>
+
+rv::AsyncLogWriter::AsyncLogWriter(std::initializer_list<LogSink*> sinks)
+	:
+	sinks(sinks),
+	thread(&AsyncLogWriter::Run, this)
+{
+}
+
+rv::AsyncLogWriter::~AsyncLogWriter()
+{
+	{
+		std::lock_guard guard(mutex);
+		running = false;
+	}
+	signal.notify_one();
+	thread.join();
+}
+
+bool rv::AsyncLogWriter::Write(const utf16_string& message, Severity severity)
+{
+	if (!ring.TryPush(message, severity))
+	{
+		dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	Wake();
+	return true;
+}
+
+void rv::AsyncLogWriter::Flush()
+{
+	const size_t target = ring.PushCount();
+	std::unique_lock lock(mutex);
+	signal.notify_one();
+	flushed.wait(lock, [this, target]() { return outputCount.load(std::memory_order_acquire) >= target; });
+}
+
+rv::u64 rv::AsyncLogWriter::Dropped() const
+{
+	return dropped.load(std::memory_order_relaxed);
+}
+
+void rv::AsyncLogWriter::Run()
+{
+	Record record;
+	u64 reported = 0;
+	while (true)
+	{
+		while (ring.TryPop(record))
+		{
+			Output(record);
+			outputCount.fetch_add(1, std::memory_order_release);
+		}
+
+		const u64 lost = dropped.load(std::memory_order_relaxed);
+		if (lost != reported)
+		{
+			record.severity = RV_SEVERITY_WARNING;
+			record.stamp.Reset();
+			record.length = 0;
+			record.overflow = str16(lost - reported, u" log messages were dropped, the log writer could not keep up");
+			Output(record);
+			reported = lost;
+		}
+		// the sinks buffer the lines and write them out in large blocks here
+		for (LogSink* sink : sinks)
+			sink->Flush();
+
+		std::unique_lock lock(mutex);
+		flushed.notify_all();
+		if (!running && !ring.Ready())
+			break;
+
+		waiting.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		signal.wait(lock, [this]() { return !running || ring.Ready(); });
+		waiting.store(false, std::memory_order_relaxed);
+	}
+}
+
+void rv::AsyncLogWriter::Output(Record& record)
+{
+	LogInfo info;
+	info.severity = record.severity;
+	info.stamp = record.stamp;
+	info.message = record.Message();
+	line.clear();
+	info.Format(line);
+	for (LogSink* sink : sinks)
+		sink->Write(line);
+}
+
+rv::AsyncLogWriter::Record::Record(const utf16_string& message, Severity severity)
+	:
+	severity(severity)
+{
+	if (message.character_size() <= inline_length)
+	{
+		length = message.character_size();
+		std::copy_n(message.c_str(), length, text);
+	}
+	else
+		overflow = message;
+}
+
+rv::utf16_string rv::AsyncLogWriter::Record::Message()
+{
+	if (!overflow.empty())
+		return std::move(overflow);
+	return std::u16string(text, length);
+}
+
+void rv::AsyncLogWriter::Wake()
+{
+	// pairs with the fence in Run: either the writer sees the new record or we see the writer waiting
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (waiting.load(std::memory_order_relaxed))
+	{
+		std::lock_guard guard(mutex);
+		signal.notify_one();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include "Engine/Utility/BinaryLogger.h"
+#include <algorithm>
+#include <thread>
+
+rv::BinaryLogger rv::binlog;
+
+// sites push themselves when their macro first runs, newest first
+static std::atomic<const rv::BinaryLogSite*> binary_log_sites = nullptr;
+static std::atomic<rv::u32> next_binary_log_site = 1;
+static std::atomic<rv::u64> next_binary_logger_id = 1;
+
+template<typename T>
+static void append(std::vector<rv::byte>& out, const T& value)
+{
+	const rv::byte* bytes = reinterpret_cast<const rv::byte*>(&value);
+	out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+static void append_string(std::vector<rv::byte>& out, const char* string)
+{
+	const rv::u32 size = (rv::u32)std::strlen(string);
+	append(out, size);
+	out.insert(out.end(), string, string + size);
+}
+
+// Starts a block, end_block fills in its size once the payload is appended
+static size_t begin_block(std::vector<rv::byte>& out, rv::BinaryLogBlock type)
+{
+	append(out, type);
+	append(out, rv::u32(0));
+	return out.size();
+}
+
+static void end_block(std::vector<rv::byte>& out, size_t start)
+{
+	const rv::u32 size = (rv::u32)(out.size() - start);
+	std::memcpy(out.data() + start - sizeof(rv::u32), &size, sizeof(size));
+}
+
+rv::BinaryLogSite::BinaryLogSite(const char* format, Severity severity, const char* file, u32 line)
+	:
+	format(format),
+	severity(severity),
+	file(file),
+	line(line),
+	id(next_binary_log_site.fetch_add(1, std::memory_order_relaxed)),
+	next(binary_log_sites.load(std::memory_order_relaxed))
+{
+	while (!binary_log_sites.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed));
+}
+
+rv::BinaryLogger::BinaryLogger()
+	:
+	id(next_binary_logger_id.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+bool rv::BinaryLogger::Dump(const char* path)
+{
+	std::lock_guard guard(dumpMutex);
+
+	// records are collected before the sites, so every site they refer to has been registered
+	std::vector<byte> records;
+	{
+		std::lock_guard bufferGuard(bufferMutex);
+		std::erase_if(buffers, [&records](const std::shared_ptr<ThreadBuffer>& buffer)
+			{
+				// read before collecting, so everything logged before the buffer was abandoned is collected
+				const bool abandoned = buffer->abandoned.load(std::memory_order_acquire);
+				Collect(*buffer, records);
+				return abandoned;
+			}
+		);
+	}
+	if (const u64 count = lost.exchange(0, std::memory_order_relaxed))
+	{
+		const size_t dropped = begin_block(records, RV_BINARY_LOG_DROPPED);
+		append(records, u64(0));
+		append(records, count);
+		end_block(records, dropped);
+	}
+
+	std::vector<byte> out;
+	if (!file.is_open() || filePath != path)
+	{
+		file.close();
+		file.open(path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return false;
+		filePath = path;
+		sitesWritten = 0;
+		append(out, binary_log_magic);
+		append(out, binary_log_version);
+	}
+
+	const size_t clock = begin_block(out, RV_BINARY_LOG_CLOCK);
+	append(out, (i64)std::chrono::steady_clock::now().time_since_epoch().count());
+	append(out, (i64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+	append(out, (i64)std::chrono::steady_clock::period::num);
+	append(out, (i64)std::chrono::steady_clock::period::den);
+	end_block(out, clock);
+
+	std::vector<const BinaryLogSite*> sites;
+	for (const BinaryLogSite* site = binary_log_sites.load(std::memory_order_acquire); site; site = site->next)
+		if (site->id > sitesWritten)
+			sites.push_back(site);
+	std::sort(sites.begin(), sites.end(), [](const BinaryLogSite* lhs, const BinaryLogSite* rhs) { return lhs->id < rhs->id; });
+	for (const BinaryLogSite* site : sites)
+	{
+		const size_t block = begin_block(out, RV_BINARY_LOG_SITE);
+		append(out, site->id);
+		append(out, (u32)site->severity);
+		append(out, site->line);
+		append_string(out, site->file);
+		append_string(out, site->format);
+		end_block(out, block);
+		sitesWritten = std::max(sitesWritten, site->id);
+	}
+
+	out.insert(out.end(), records.begin(), records.end());
+	file.write(reinterpret_cast<const char*>(out.data()), out.size());
+	file.flush();
+	return file.good();
+}
+
+void rv::BinaryLogger::Collect(ThreadBuffer& buffer, std::vector<byte>& out)
+{
+	std::lock_guard guard(buffer.chunkMutex);
+
+	const size_t start = begin_block(out, RV_BINARY_LOG_RECORDS);
+	append(out, buffer.thread);
+	const size_t payload = out.size();
+
+	// full chunks are no longer written to and can be reused, the current one is only read up to its published size
+	while (buffer.first != buffer.current)
+	{
+		Chunk* chunk = buffer.first;
+		const size_t size = chunk->size.load(std::memory_order_acquire);
+		out.insert(out.end(), chunk->data + buffer.dumped, chunk->data + size);
+		buffer.first = chunk->next;
+		buffer.dumped = 0;
+		--buffer.chunks;
+		chunk->next = buffer.free;
+		buffer.free = chunk;
+	}
+	const size_t size = buffer.current->size.load(std::memory_order_acquire);
+	out.insert(out.end(), buffer.current->data + buffer.dumped, buffer.current->data + size);
+	buffer.dumped = size;
+
+	if (out.size() == payload)
+		out.resize(start - sizeof(u32) - sizeof(BinaryLogBlock));
+	else
+		end_block(out, start);
+
+	const u64 dropped = buffer.dropped.load(std::memory_order_relaxed);
+	if (dropped != buffer.droppedDumped)
+	{
+		const size_t block = begin_block(out, RV_BINARY_LOG_DROPPED);
+		append(out, buffer.thread);
+		append(out, dropped - buffer.droppedDumped);
+		end_block(out, block);
+		buffer.droppedDumped = dropped;
+	}
+}
+
+rv::BinaryLogger::ThreadBuffer::ThreadBuffer(u64 thread)
+	:
+	thread(thread),
+	first(new Chunk),
+	current(first)
+{
+}
+
+rv::BinaryLogger::ThreadBuffer::~ThreadBuffer()
+{
+	for (Chunk* list : { first, free })
+		while (list)
+		{
+			Chunk* next = list->next;
+			delete list;
+			list = next;
+		}
+}
+
+rv::byte* rv::BinaryLogger::ThreadBuffer::Grow()
+{
+	std::lock_guard guard(chunkMutex);
+	if (chunks == max_chunks)
+		return nullptr;
+
+	Chunk* chunk = free;
+	if (chunk)
+	{
+		free = chunk->next;
+		chunk->next = nullptr;
+		chunk->size.store(0, std::memory_order_relaxed);
+	}
+	else
+		chunk = new Chunk;
+	current->next = chunk;
+	current = chunk;
+	++chunks;
+	return chunk->data;
+}
+
+rv::BinaryLogger::ThreadBuffer* rv::BinaryLogger::LocalBuffer()
+{
+	// loggers are identified by an id instead of their address, which could be reused by a new logger
+	// trivially destructible, so logging from destructors that run after the release below is still safe
+	thread_local u64 lastLogger = 0;
+	thread_local ThreadBuffer* lastBuffer = nullptr;
+	thread_local bool released = false;
+	if (lastLogger == id)
+		return lastBuffer;
+	if (released)
+		return nullptr;
+
+	// hands the buffer back when the thread exits, the next dump collects what is left in it and frees it
+	struct Release
+	{
+		~Release()
+		{
+			if (buffer)
+				buffer->abandoned.store(true, std::memory_order_release);
+			lastLogger = 0;
+			lastBuffer = nullptr;
+			released = true;
+		}
+
+		std::shared_ptr<ThreadBuffer> buffer;
+	};
+	thread_local Release release;
+
+	// a thread keeps a buffer for the logger it used last, switching loggers hands the previous one back like an exit
+	if (release.buffer)
+		release.buffer->abandoned.store(true, std::memory_order_release);
+	release.buffer = RegisterThread();
+	lastLogger = id;
+	lastBuffer = release.buffer.get();
+	return lastBuffer;
+}
+
+std::shared_ptr<rv::BinaryLogger::ThreadBuffer> rv::BinaryLogger::RegisterThread()
+{
+	auto buffer = std::make_shared<ThreadBuffer>((u64)std::hash<std::thread::id>()(std::this_thread::get_id()));
+	std::lock_guard guard(bufferMutex);
+	buffers.push_back(buffer);
+	return buffer;
+}
+
+void rv::BinaryLogger::Drop(ThreadBuffer* buffer)
+{
+	if (buffer)
+		buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	else
+		lost.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,102 @@
+#include "Engine/Utility/CopyOnWrite.h"
+
+static std::atomic<rv::detail::ReaderSlots*> reader_slots = nullptr;
+
+static void publish_reader_slots(rv::detail::ReaderSlots* slots)
+{
+	slots->next = reader_slots.load(std::memory_order_relaxed);
+	while (!reader_slots.compare_exchange_weak(slots->next, slots, std::memory_order_release, std::memory_order_relaxed));
+}
+
+static rv::detail::ReaderSlots* claim_reader_slots()
+{
+	// records of finished threads are reused, they are never freed so writers can always walk the list
+	for (rv::detail::ReaderSlots* slots = reader_slots.load(std::memory_order_acquire); slots; slots = slots->next)
+	{
+		bool claimed = false;
+		if (slots->claimed.compare_exchange_strong(claimed, true, std::memory_order_acquire))
+			return slots;
+	}
+
+	rv::detail::ReaderSlots* slots = new rv::detail::ReaderSlots();
+	slots->claimed.store(true, std::memory_order_relaxed);
+	publish_reader_slots(slots);
+	return slots;
+}
+
+// Claims a single slot of the shared records, they stay claimed so no thread ever takes them over as its own
+static std::atomic<const void*>& claim_shared_slot()
+{
+	// marks the slot as taken until the read stores its version, it never matches a version so it pins nothing
+	static const char taken = 0;
+
+	for (rv::detail::ReaderSlots* slots = reader_slots.load(std::memory_order_acquire); slots; slots = slots->next)
+	{
+		if (!slots->shared)
+			continue;
+		for (std::atomic<const void*>& slot : slots->versions)
+		{
+			const void* expected = nullptr;
+			if (slot.compare_exchange_strong(expected, &taken, std::memory_order_acquire))
+				return slot;
+		}
+	}
+
+	rv::detail::ReaderSlots* slots = new rv::detail::ReaderSlots();
+	slots->shared = true;
+	slots->claimed.store(true, std::memory_order_relaxed);
+	slots->versions[0].store(&taken, std::memory_order_relaxed);
+	publish_reader_slots(slots);
+	return slots->versions[0];
+}
+
+// trivially destructible, so reads from destructors that run after the thread's cleanup still work
+static thread_local rv::detail::ReaderSlots* thread_slots = nullptr;
+// set once the thread's records were given back, later reads of the thread use shared slots instead of claiming a record nobody would release
+static thread_local bool thread_released = false;
+
+namespace
+{
+	struct ThreadSlotsRelease
+	{
+		~ThreadSlotsRelease()
+		{
+			rv::detail::ReaderSlots* slots = thread_slots;
+			while (slots)
+			{
+				// another thread may claim the record and relink owned as soon as it is released
+				rv::detail::ReaderSlots* owned = slots->owned;
+				slots->claimed.store(false, std::memory_order_release);
+				slots = owned;
+			}
+			thread_slots = nullptr;
+			thread_released = true;
+		}
+	};
+}
+
+std::atomic<const void*>& rv::detail::acquire_reader_slot()
+{
+	for (ReaderSlots* slots = thread_slots; slots; slots = slots->owned)
+		for (std::atomic<const void*>& slot : slots->versions)
+			if (!slot.load(std::memory_order_relaxed))
+				return slot;
+
+	if (thread_released)
+		return claim_shared_slot();
+
+	// only happens on the first read of a thread, or when reads are nested deeper than the slots it already has
+	thread_local ThreadSlotsRelease release;
+	ReaderSlots* slots = claim_reader_slots();
+	slots->owned = thread_slots;
+	thread_slots = slots;
+	return slots->versions[0];
+}
+
+void rv::detail::collect_read_versions(std::vector<const void*>& versions)
+{
+	for (ReaderSlots* slots = reader_slots.load(std::memory_order_acquire); slots; slots = slots->next)
+		for (const std::atomic<const void*>& slot : slots->versions)
+			if (const void* version = slot.load(std::memory_order_seq_cst))
+				versions.push_back(version);
+}
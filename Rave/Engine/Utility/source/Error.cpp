@@ -163,7 +163,7 @@ rv::Result rv::check_last(bool condition, const char* source, uint64 line)
 {
 	if (condition)
 		return succeeded_hr;
-	return check_hr((HRESULT)GetLastError(), source, line);
+	return check_hr(HRESULT_FROM_WIN32(GetLastError()), source, line);
 }
 
 rv::Result rv::check_last(bool condition, const char* source, uint64 line, utf16_string&& message)
@@ -1,5 +1,184 @@
 #include "Engine/Utility/Event.h"
 
+bool rv::EventLogger::Registry::Subscribed(u64 type) const
+{
+	if (!listeners.empty())
+		return true;
+	auto typed = typedListeners.find(type);
+	return typed != typedListeners.end() && !typed->second.empty();
+}
+
+void rv::EventLogger::Registry::Compact()
+{
+	auto closed = [](const std::shared_ptr<EventQueue>& listener) { return listener->Closed(); };
+	std::erase_if(listeners, closed);
+	for (auto it = typedListeners.begin(); it != typedListeners.end();)
+	{
+		std::erase_if(it->second, closed);
+		if (it->second.empty())
+			it = typedListeners.erase(it);
+		else
+			++it;
+	}
+}
+
+bool rv::EventLogger::Post(const Registry& registry, Queue<EmptyInfo>::Header* header)
+{
+	auto typed = registry.typedListeners.find(header->type);
+	auto coalesce = registry.coalescing.find(header->type);
+	bool live = true;
+	if (coalesce == registry.coalescing.end())
+	{
+		live &= Deliver(registry.listeners, header);
+		if (typed != registry.typedListeners.end())
+			live &= Deliver(typed->second, header);
+	}
+	else
+	{
+		live &= Deliver(registry.listeners, header, coalesce->second);
+		if (typed != registry.typedListeners.end())
+			live &= Deliver(typed->second, header, coalesce->second);
+	}
+	return live;
+}
+
+bool rv::EventLogger::Deliver(const ListenerList& list, Queue<EmptyInfo>::Header* header)
+{
+	bool live = true;
+	for (auto& listener : list)
+	{
+		if (listener->Closed())
+		{
+			live = false;
+			continue;
+		}
+		listener->Push(header);
+	}
+	return live;
+}
+
+bool rv::EventLogger::Deliver(const ListenerList& list, Queue<EmptyInfo>::Header* header, EventMerger merger)
+{
+	bool live = true;
+	for (auto& listener : list)
+	{
+		if (listener->Closed())
+		{
+			live = false;
+			continue;
+		}
+		listener->Push(header, merger);
+	}
+	return live;
+}
+
+bool rv::EventLogger::Collect(const ListenerList& list, Queue<EmptyInfo>::Header* header, std::unordered_map<EventQueue*, std::vector<Queue<EmptyInfo>::Header*>>& batches)
+{
+	bool live = true;
+	for (auto& listener : list)
+	{
+		if (listener->Closed())
+			live = false;
+		else
+			batches[listener.get()].push_back(header);
+	}
+	return live;
+}
+
+void rv::EventLogger::PostBatch(Queue<EmptyInfo>::Header* const* headers, size_t count)
+{
+	std::unordered_map<EventQueue*, std::vector<Queue<EmptyInfo>::Header*>> batches;
+	bool stale = false;
+	{
+		auto registry = this->registry.Read();
+		for (size_t i = 0; i < count; ++i)
+		{
+			stale |= !Collect(registry->listeners, headers[i], batches);
+			auto typed = registry->typedListeners.find(headers[i]->type);
+			if (typed != registry->typedListeners.end())
+				stale |= !Collect(typed->second, headers[i], batches);
+		}
+		// the snapshot keeps every queue in the batch alive
+		for (auto& [listener, batch] : batches)
+			listener->Push(batch.data(), batch.size());
+	}
+	if (stale)
+		Compact();
+}
+
+void rv::EventLogger::Compact()
+{
+	// posting never waits for registration, if another thread is updating the registry it will compact it instead
+	registry.TryUpdate([](Registry& registry) { registry.Compact(); });
+}
+
+void rv::EventQueue::Push(Queue<EmptyInfo>::Header* header)
+{
+	queue.Push(header);
+	Notify();
+}
+
+void rv::EventQueue::Push(Queue<EmptyInfo>::Header* const* headers, size_t count)
+{
+	queue.Push(headers, count);
+	Notify();
+}
+
+void rv::EventQueue::Push(Queue<EmptyInfo>::Header* header, EventMerger merger)
+{
+	if (merger)
+		queue.PushMerged(header->type, header, merger);
+	else
+		queue.PushLatest(header->type, header);
+	Notify();
+}
+
+void rv::EventQueue::Close()
+{
+	closed.store(true, std::memory_order_relaxed);
+}
+
+bool rv::EventQueue::Closed() const
+{
+	return closed.load(std::memory_order_relaxed);
+}
+
+void rv::EventQueue::Notify()
+{
+	// pairs with the fence in Wait: either the waiter sees the new event or we see the waiter
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (waiting.load(std::memory_order_relaxed))
+	{
+		std::lock_guard guard(waitMutex);
+		signal.notify_one();
+	}
+}
+
+bool rv::EventQueue::Wait(std::chrono::nanoseconds timeout)
+{
+	if (!queue.Empty())
+		return true;
+
+	std::unique_lock lock(waitMutex);
+	waiting.store(true, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	bool ready = signal.wait_for(lock, timeout, [this]() { return !queue.Empty(); });
+	waiting.store(false, std::memory_order_relaxed);
+	return ready;
+}
+
+void rv::EventQueue::Wait()
+{
+	if (!queue.Empty())
+		return;
+
+	std::unique_lock lock(waitMutex);
+	waiting.store(true, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	signal.wait(lock, [this]() { return !queue.Empty(); });
+	waiting.store(false, std::memory_order_relaxed);
+}
+
 rv::EventListener::EventListener(EventLogger& logger)
 {
 	Listen(logger);
@@ -10,11 +189,34 @@ rv::EventListener::EventListener(EventSource& source)
 	Listen(source);
 }
 
+rv::EventListener::EventListener(EventListener&& rhs) noexcept
+	:
+	events(std::move(rhs.events))
+{
+}
+
+rv::EventListener::~EventListener()
+{
+	StopListening();
+}
+
+rv::EventListener& rv::EventListener::operator=(EventListener&& rhs) noexcept
+{
+	StopListening();
+	events = std::move(rhs.events);
+	return *this;
+}
+
 void rv::EventListener::Listen(EventLogger& logger)
 {
+	StopListening();
 	events = std::make_shared<EventQueue>();
-	std::lock_guard guard(logger.mutex);
-	logger.listeners.push_back(events);
+	logger.registry.Update([this](EventLogger::Registry& registry)
+		{
+			registry.Compact();
+			registry.listeners.push_back(events);
+		}
+	);
 }
 
 void rv::EventListener::Listen(EventSource& source)
@@ -24,6 +226,9 @@ void rv::EventListener::Listen(EventSource& source)
 
 void rv::EventListener::StopListening()
 {
+	// the logger may still hold the queue, it drops it on its next update
+	if (events)
+		events->Close();
 	events.reset();
 }
 
@@ -31,24 +236,40 @@ rv::Event rv::EventListener::GetEvent()
 {
 	if (!events)
 		return nullptr;
-	std::lock_guard guard(events->mutex);
-	return events->queue.GetHeader();
+	return events->queue.Pop();
+}
+
+rv::Event rv::EventListener::WaitEvent()
+{
+	if (!events)
+		return nullptr;
+	events->Wait();
+	return events->queue.Pop();
+}
+
+rv::Event rv::EventListener::WaitEvent(std::chrono::nanoseconds timeout)
+{
+	if (!events || !events->Wait(timeout))
+		return nullptr;
+	return events->queue.Pop();
+}
+
+size_t rv::EventListener::DrainEvents(std::vector<Event>& out)
+{
+	if (!events)
+		return 0;
+	return events->queue.Drain([&out](Queue<EmptyInfo>::Header* header) { out.emplace_back(header); });
 }
 
 rv::Event::Event(Queue<EmptyInfo>::Header* header)
 	:
 	header(header)
 {
-	if (header)
-	{
-		header->prev = nullptr;
-		header->next = nullptr;
-	}
 }
 
 rv::Event::Event(Event&& rhs) noexcept
 	:
-	header(header)
+	header(rhs.header)
 {
 	rhs.header = nullptr;
 }
@@ -78,6 +299,6 @@ bool rv::Event::Empty() const
 
 void rv::Event::Clear()
 {
-	if (header)
-		delete header;
+	Queue<EmptyInfo>::Release(header);
+	header = nullptr;
 }
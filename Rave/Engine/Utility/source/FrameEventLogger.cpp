@@ -0,0 +1,68 @@
+#include "Engine/Utility/FrameEventLogger.h"
+#include <algorithm>
+
+static std::atomic<rv::u64> next_logger_id = 1;
+
+rv::FrameEventLogger::FrameEventLogger()
+	:
+	id(next_logger_id.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+rv::FrameEventLogger::~FrameEventLogger()
+{
+	for (auto& [thread, buffer] : buffers)
+		for (const Record& record : buffer->records)
+			Queue<EmptyInfo>::Release(record.header);
+}
+
+void rv::FrameEventLogger::Flush()
+{
+	std::lock_guard guard(bufferMutex);
+
+	// every thread buffer is already ordered, so merging them keeps the whole batch ordered
+	merged.clear();
+	for (auto& [thread, buffer] : buffers)
+	{
+		if (buffer->records.empty())
+			continue;
+		const size_t middle = merged.size();
+		merged.insert(merged.end(), buffer->records.begin(), buffer->records.end());
+		buffer->records.clear();
+		std::inplace_merge(merged.begin(), merged.begin() + middle, merged.end(), [](const Record& lhs, const Record& rhs) { return lhs.stamp < rhs.stamp; });
+	}
+	if (merged.empty())
+		return;
+
+	batch.clear();
+	for (const Record& record : merged)
+		batch.push_back(record.header);
+
+	PostBatch(batch.data(), batch.size());
+	for (Queue<EmptyInfo>::Header* header : batch)
+		Queue<EmptyInfo>::Release(header);
+}
+
+rv::FrameEventLogger::ThreadBuffer& rv::FrameEventLogger::LocalBuffer()
+{
+	// loggers are identified by an id instead of their address, which could be reused by a new logger
+	thread_local u64 lastLogger = 0;
+	thread_local ThreadBuffer* lastBuffer = nullptr;
+	if (lastLogger == id)
+		return *lastBuffer;
+
+	// the buffers are owned by the logger, so nothing outlives it on the posting threads
+	ThreadBuffer& buffer = RegisterThread();
+	lastLogger = id;
+	lastBuffer = &buffer;
+	return buffer;
+}
+
+rv::FrameEventLogger::ThreadBuffer& rv::FrameEventLogger::RegisterThread()
+{
+	std::lock_guard guard(bufferMutex);
+	std::unique_ptr<ThreadBuffer>& buffer = buffers[std::this_thread::get_id()];
+	if (!buffer)
+		buffer = std::make_unique<ThreadBuffer>();
+	return *buffer;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "Engine/Utility/Hasher.h"
+#include <cstring>
+
+using namespace rv::detail;
+
+rv::detail::Xxh3State::Xxh3State()
+{
+	Reset();
+}
+
+void rv::detail::Xxh3State::Reset()
+{
+	std::memcpy(acc, xxh3::initial_accumulators, sizeof(acc));
+	buffered = 0;
+	blockStripes = 0;
+	length = 0;
+}
+
+void rv::detail::Xxh3State::Update(const u8* data, size_t size)
+{
+	if (size == 0)
+		return;
+
+	const u8* end = data + size;
+	length += size;
+
+	if (size <= buffer_size - buffered)
+	{
+		std::memcpy(buffer + buffered, data, size);
+		buffered += size;
+		return;
+	}
+
+	if (buffered)
+	{
+		const size_t load = buffer_size - buffered;
+		std::memcpy(buffer + buffered, data, load);
+		data += load;
+		Consume(acc, blockStripes, buffer, buffer_size / xxh3::stripe_size);
+		buffered = 0;
+	}
+
+	// at least one byte is always left in the buffer, so the last stripe is only accumulated when the hash is finalized
+	if ((size_t)(end - data) > buffer_size)
+	{
+		data = Consume(acc, blockStripes, data, (size_t)(end - 1 - data) / xxh3::stripe_size);
+		std::memcpy(buffer + buffer_size - xxh3::stripe_size, data - xxh3::stripe_size, xxh3::stripe_size);
+	}
+
+	std::memcpy(buffer, data, (size_t)(end - data));
+	buffered = (size_t)(end - data);
+}
+
+rv::u64 rv::detail::Xxh3State::Digest64() const
+{
+	// short inputs never leave the buffer
+	if (length <= xxh3::midsize_max)
+		return xxh3::hash_64(HashInput<u8>{ buffer, (size_t)length });
+
+	u64 accumulators[xxh3::accumulator_count];
+	DigestLong(accumulators);
+	return xxh3::digest_long_64(accumulators, length);
+}
+
+rv::Hash128 rv::detail::Xxh3State::Digest128() const
+{
+	if (length <= xxh3::midsize_max)
+		return xxh3::hash_128(HashInput<u8>{ buffer, (size_t)length });
+
+	u64 accumulators[xxh3::accumulator_count];
+	DigestLong(accumulators);
+	return xxh3::digest_long_128(accumulators, length);
+}
+
+const rv::u8* rv::detail::Xxh3State::Consume(u64* accumulators, size_t& stripesInBlock, const u8* input, size_t stripes)
+{
+	size_t secretOffset = stripesInBlock * xxh3::secret_consume_rate;
+	if (stripes >= xxh3::stripes_per_block - stripesInBlock)
+	{
+		size_t count = xxh3::stripes_per_block - stripesInBlock;
+		do
+		{
+			xxh3_accumulate_stripes(accumulators, input, count, secretOffset);
+			xxh3_scramble_accumulators(accumulators);
+			input += count * xxh3::stripe_size;
+			stripes -= count;
+			count = xxh3::stripes_per_block;
+			secretOffset = 0;
+		} while (stripes >= xxh3::stripes_per_block);
+		stripesInBlock = 0;
+	}
+	if (stripes > 0)
+	{
+		xxh3_accumulate_stripes(accumulators, input, stripes, secretOffset);
+		input += stripes * xxh3::stripe_size;
+		stripesInBlock += stripes;
+	}
+	return input;
+}
+
+void rv::detail::Xxh3State::DigestLong(u64* accumulators) const
+{
+	std::memcpy(accumulators, acc, sizeof(acc));
+
+	u8 tail[xxh3::stripe_size];
+	const u8* last;
+	if (buffered >= xxh3::stripe_size)
+	{
+		size_t stripes = blockStripes;
+		Consume(accumulators, stripes, buffer, (buffered - 1) / xxh3::stripe_size);
+		last = buffer + buffered - xxh3::stripe_size;
+	}
+	else
+	{
+		// the final stripe starts in the previously accumulated input
+		const size_t previous = xxh3::stripe_size - buffered;
+		std::memcpy(tail, buffer + buffer_size - previous, previous);
+		std::memcpy(tail + previous, buffer, buffered);
+		last = tail;
+	}
+	xxh3::accumulate_512(accumulators, HashInput<u8>{ last, xxh3::stripe_size }, 0, xxh3::secret_size - xxh3::stripe_size - 7);
+}
\ No newline at end of file
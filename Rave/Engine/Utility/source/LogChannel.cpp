@@ -0,0 +1,22 @@
+#include "Engine/Utility/LogChannel.h"
+
+rv::LogFilter::LogFilter()
+{
+	SetThreshold(RV_SEVERITY_INFO);
+}
+
+void rv::LogFilter::SetThreshold(LogChannel channel, Severity minimum)
+{
+	thresholds[channel].store((u8)minimum, std::memory_order_relaxed);
+}
+
+void rv::LogFilter::SetThreshold(Severity minimum)
+{
+	for (auto& threshold : thresholds)
+		threshold.store((u8)minimum, std::memory_order_relaxed);
+}
+
+void rv::LogFilter::Silence(LogChannel channel)
+{
+	thresholds[channel].store(silenced, std::memory_order_relaxed);
+}
\ No newline at end of file
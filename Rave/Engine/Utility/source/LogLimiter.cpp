@@ -0,0 +1,62 @@
+#include "Engine/Utility/LogLimiter.h"
+#include <algorithm>
+
+void rv::LogLimiter::SetBudget(const LogBudget& budget)
+{
+	burst.store(budget.burst, std::memory_order_relaxed);
+	perSecond.store(budget.perSecond, std::memory_order_relaxed);
+}
+
+rv::LogLimiter::Site* rv::LogLimiter::Find(u64 site)
+{
+	// 0 marks a free slot
+	if (site == 0)
+		site = 1;
+
+	for (size_t i = 0; i < max_sites; ++i)
+	{
+		Site& entry = sites[(site + i) % max_sites];
+		u64 key = entry.key.load(std::memory_order_acquire);
+		if (key == 0 && entry.key.compare_exchange_strong(key, site, std::memory_order_acq_rel))
+			return &entry;
+		// a failed exchange loads the key that claimed the slot
+		if (key == site)
+			return &entry;
+	}
+	return nullptr;
+}
+
+bool rv::LogLimiter::Take(Site& site, utf16_string& summary, bool& sample)
+{
+	const auto now = std::chrono::steady_clock::now();
+	const double burst = (double)this->burst.load(std::memory_order_relaxed);
+
+	if (site.refilled == std::chrono::steady_clock::time_point())
+		site.tokens = burst;
+	else
+		site.tokens = std::min(burst, site.tokens + std::chrono::duration<double>(now - site.refilled).count() * perSecond.load(std::memory_order_relaxed));
+	site.refilled = now;
+
+	if (site.tokens < 1.0)
+	{
+		if (site.dropped++ == 0)
+			site.firstDropped = now;
+		return false;
+	}
+
+	site.tokens -= 1.0;
+	sample = site.tokens < 1.0;
+	summary = Summarize(site, now);
+	return true;
+}
+
+rv::utf16_string rv::LogLimiter::Summarize(Site& site, std::chrono::steady_clock::time_point now)
+{
+	if (site.dropped == 0)
+		return {};
+
+	const auto window = std::chrono::duration_cast<std::chrono::milliseconds>(now - site.firstDropped).count();
+	utf16_string summary = str16(u'\"', site.message, strvalid(u"\" repeated "), site.dropped, strvalid(u" times in the last "), window, strvalid(u" ms"));
+	site.dropped = 0;
+	return summary;
+}
\ No newline at end of file
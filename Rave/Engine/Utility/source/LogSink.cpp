@@ -0,0 +1,151 @@
+#include "Engine/Utility/LogSink.h"
+#include "Engine/Utility/Error.h"
+
+void rv::LogSink::Write(std::string_view line)
+{
+	std::lock_guard guard(mutex);
+	if (buffer.size() + line.size() + 1 > buffer_size && !buffer.empty())
+	{
+		WriteBuffer(buffer);
+		buffer.clear();
+	}
+	buffer.append(line);
+	buffer.push_back('\n');
+}
+
+void rv::LogSink::Flush()
+{
+	std::lock_guard guard(mutex);
+	if (!buffer.empty())
+	{
+		WriteBuffer(buffer);
+		buffer.clear();
+	}
+}
+
+rv::ConsoleSink::ConsoleSink()
+	:
+	handle(GetStdHandle(STD_OUTPUT_HANDLE))
+{
+	// the console decodes the bytes it's given with the output code page
+	SetConsoleOutputCP(CP_UTF8);
+	buffer.reserve(buffer_size);
+}
+
+rv::ConsoleSink::~ConsoleSink()
+{
+	Flush();
+}
+
+void rv::ConsoleSink::WriteBuffer(std::string_view data)
+{
+	if (!handle || handle == INVALID_HANDLE_VALUE)
+		return;
+
+	while (!data.empty())
+	{
+		DWORD written = 0;
+		if (!WriteFile(handle, data.data(), (DWORD)data.size(), &written, nullptr) || written == 0)
+			return;
+		data.remove_prefix(written);
+	}
+}
+
+rv::RotatingFileSink::~RotatingFileSink()
+{
+	Close();
+}
+
+rv::Result rv::RotatingFileSink::Open(const LogRotation& rotation)
+{
+	std::lock_guard guard(mutex);
+	if (file)
+	{
+		WriteBuffer(buffer);
+		buffer.clear();
+		CloseFile();
+	}
+
+	this->rotation = rotation;
+	std::error_code error;
+	if (std::filesystem::file_size(rotation.path, error) > 0 && !error)
+		Rotate();
+	return Create();
+}
+
+void rv::RotatingFileSink::Close()
+{
+	std::lock_guard guard(mutex);
+	if (file)
+		WriteBuffer(buffer);
+	buffer.clear();
+	CloseFile();
+}
+
+void rv::RotatingFileSink::WriteBuffer(std::string_view data)
+{
+	if (!file)
+		return;
+
+	const bool full = rotation.maxBytes && size + data.size() > rotation.maxBytes && size > 0;
+	const bool old = rotation.maxAge.count() && std::chrono::steady_clock::now() - opened >= rotation.maxAge;
+	if (full || old)
+	{
+		CloseFile();
+		Rotate();
+		if (Create().failed())
+			return;
+	}
+
+	while (!data.empty())
+	{
+		DWORD written = 0;
+		if (!WriteFile(file, data.data(), (DWORD)data.size(), &written, nullptr) || written == 0)
+			return;
+		data.remove_prefix(written);
+		size += written;
+	}
+}
+
+rv::Result rv::RotatingFileSink::Create()
+{
+	file = CreateFileW(rotation.path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		file = nullptr;
+		return rv_check_last(false);
+	}
+	buffer.reserve(buffer_size);
+	size = 0;
+	opened = std::chrono::steady_clock::now();
+	return success;
+}
+
+void rv::RotatingFileSink::CloseFile()
+{
+	if (file)
+		CloseHandle(file);
+	file = nullptr;
+}
+
+void rv::RotatingFileSink::Rotate()
+{
+	// failures leave the files where they are, the new file then replaces the current one
+	const auto rotated = [this](u32 index)
+	{
+		std::filesystem::path path = rotation.path;
+		path += L'.' + std::to_wstring(index);
+		return path;
+	};
+
+	std::error_code error;
+	if (rotation.keep == 0)
+	{
+		std::filesystem::remove(rotation.path, error);
+		return;
+	}
+	std::filesystem::remove(rotated(rotation.keep), error);
+	for (u32 index = rotation.keep - 1; index > 0; --index)
+		std::filesystem::rename(rotated(index), rotated(index + 1), error);
+	std::filesystem::rename(rotation.path, rotated(1), error);
+}
\ No newline at end of file
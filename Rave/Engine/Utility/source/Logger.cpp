@@ -1,4 +1,6 @@
 #include "Engine/Utility/Logger.h"
+#include "Engine/Utility/Error.h"
+#include <cstring>
 
 rv::DebugLogger rv::debug;
 
@@ -8,34 +10,172 @@ void rv::Logger::Log(const utf16_string& message, Severity severity)
 	info.message = message;
 	info.severity = severity;
 
+	Post([&info]() { return Queue<LogInfo>::MakeEntry(info); });
+
 	std::lock_guard global_guard(mutex);
-	loggedInfo.push_back(info);
+	history.Push(std::move(info));
+}
+
+rv::Result rv::Logger::SetRetention(const LogRetention& retention)
+{
+	std::lock_guard guard(mutex);
+	return history.SetRetention(retention);
+}
+
+bool rv::Logger::Deliver(const ListenerList& listeners, Queue<LogInfo>::Header* header)
+{
+	bool live = true;
 	for (auto& listener : listeners)
 	{
-		if (listener.use_count() == 1)
+		if (listener->Closed())
 		{
-			listener.reset();
+			live = false;
 			continue;
 		}
-		std::lock_guard guard(listener->mutex);
-		listener->queue.PushEntry(info);
+		listener->queue.Push(header);
+	}
+	return live;
+}
+
+void rv::Logger::Compact(ListenerList& listeners)
+{
+	std::erase_if(listeners, [](const std::shared_ptr<LogQueue>& listener) { return listener->Closed(); });
+}
+
+void rv::Logger::Compact()
+{
+	// logging never waits for registration, if another thread is updating the list it will compact it instead
+	listeners.TryUpdate([](ListenerList& listeners) { Compact(listeners); });
+}
+
+/*
+	Spilled record layout:
+	u32 record size, u32 severity, TimeStamp, u32 message size in code units, message
+*/
+static_assert(std::is_trivially_copyable_v<rv::TimeStamp>, "Spilled log records store the TimeStamp as raw bytes");
+
+template<typename T>
+static void append_bytes(std::vector<rv::byte>& out, const T& value)
+{
+	const rv::byte* bytes = reinterpret_cast<const rv::byte*>(&value);
+	out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+static void read_bytes(const rv::byte*& in, T& value)
+{
+	std::memcpy(&value, in, sizeof(T));
+	in += sizeof(T);
+}
+
+rv::Result rv::LogHistory::SetRetention(const LogRetention& retention)
+{
+	rv_result;
+
+	if (retention.spillFile != this->retention.spillFile)
+	{
+		spill.Close();
+		spilled = 0;
+		if (!retention.spillFile.empty())
+			rv_rif(spill.Create(retention.spillFile));
 	}
+	this->retention = retention;
+	Evict();
+	return result;
+}
+
+void rv::LogHistory::Push(LogInfo&& info)
+{
+	recordBytes += MemorySize(info);
+	records.push_back(std::move(info));
+	Evict();
+}
+
+size_t rv::LogHistory::Size() const
+{
+	return spilled + records.size();
+}
+
+size_t rv::LogHistory::Discarded() const
+{
+	return discarded;
+}
+
+void rv::LogHistory::Evict()
+{
+	while (!records.empty() && (records.size() > retention.maxRecords || recordBytes > retention.maxBytes))
+	{
+		const LogInfo& info = records.front();
+		bool written = false;
+		if (spill.IsOpen())
+		{
+			const std::u16string& message = info.message.std_string();
+			const u32 size = (u32)(3 * sizeof(u32) + sizeof(TimeStamp) + message.size() * sizeof(char16_t));
+			const u32 severity = (u32)info.severity;
+			const u32 length = (u32)message.size();
+
+			std::vector<byte> record;
+			record.reserve(size);
+			append_bytes(record, size);
+			append_bytes(record, severity);
+			append_bytes(record, info.stamp);
+			append_bytes(record, length);
+			record.insert(record.end(), reinterpret_cast<const byte*>(message.data()), reinterpret_cast<const byte*>(message.data() + message.size()));
+
+			written = spill.Append(record.data(), record.size()).succeeded();
+		}
+		if (written)
+			++spilled;
+		else
+			++discarded;
+
+		recordBytes -= MemorySize(info);
+		records.pop_front();
+	}
+}
+
+bool rv::LogHistory::ReadSpilled(size_t& offset, LogInfo& info) const
+{
+	if (!spill.Data() || offset >= spill.Size())
+		return false;
+
+	const byte* in = spill.Data() + offset;
+	u32 size, severity, length;
+	read_bytes(in, size);
+	read_bytes(in, severity);
+	read_bytes(in, info.stamp);
+	read_bytes(in, length);
+
+	info.severity = (Severity)severity;
+	info.message = std::u16string(reinterpret_cast<const char16_t*>(in), length);
+	offset += size;
+	return true;
+}
+
+size_t rv::LogHistory::MemorySize(const LogInfo& info)
+{
+	return sizeof(LogInfo) + info.message.character_size() * sizeof(char16_t);
+}
+
+void rv::LogQueue::Close()
+{
+	closed.store(true, std::memory_order_relaxed);
+}
+
+bool rv::LogQueue::Closed() const
+{
+	return closed.load(std::memory_order_relaxed);
 }
 
 rv::LogEvent::LogEvent(Queue<LogInfo>::Header* header)
 	:
 	header(header)
 {
-	if (header)
-	{
-		header->prev = nullptr;
-		header->next = nullptr;
-	}
 }
 
 rv::LogEvent::LogEvent(LogEvent&& rhs) noexcept
 	:
-	header(header)
+	header(rhs.header)
 {
 	rhs.header = nullptr;
 }
@@ -63,21 +203,11 @@ bool rv::LogEvent::Empty() const
 	return !header;
 }
 
-rv::TimeStamp& rv::LogEvent::Time()
-{
-	return header->info.stamp;
-}
-
 const rv::TimeStamp& rv::LogEvent::Time() const
 {
 	return header->info.stamp;
 }
 
-rv::utf16_string& rv::LogEvent::Message()
-{
-	return header->info.message;
-}
-
 const rv::utf16_string& rv::LogEvent::Message() const
 {
 	return header->info.message;
@@ -100,8 +230,8 @@ void rv::LogEvent::Format(std::wostream& ss) const
 
 void rv::LogEvent::Clear()
 {
-	if (header)
-		delete header;
+	Queue<LogInfo>::Release(header);
+	header = nullptr;
 }
 
 rv::LogListener::LogListener(Logger& logger)
@@ -109,15 +239,41 @@ rv::LogListener::LogListener(Logger& logger)
 	Listen(logger);
 }
 
+rv::LogListener::LogListener(LogListener&& rhs) noexcept
+	:
+	events(std::move(rhs.events))
+{
+}
+
+rv::LogListener::~LogListener()
+{
+	StopListening();
+}
+
+rv::LogListener& rv::LogListener::operator=(LogListener&& rhs) noexcept
+{
+	StopListening();
+	events = std::move(rhs.events);
+	return *this;
+}
+
 void rv::LogListener::Listen(Logger& logger)
 {
+	StopListening();
 	events = std::make_shared<LogQueue>();
-	std::lock_guard guard(logger.mutex);
-	logger.listeners.push_back(events);
+	logger.listeners.Update([this](Logger::ListenerList& listeners)
+		{
+			Logger::Compact(listeners);
+			listeners.push_back(events);
+		}
+	);
 }
 
 void rv::LogListener::StopListening()
 {
+	// the logger may still hold the queue, it drops it on its next update
+	if (events)
+		events->Close();
 	events.reset();
 }
 
@@ -125,28 +281,51 @@ rv::LogEvent rv::LogListener::GetEvent()
 {
 	if (!events)
 		return nullptr;
-	std::lock_guard guard(events->mutex);
-	return events->queue.GetHeader();
+	return events->queue.Pop();
 }
 
 #ifdef RV_DEBUG_LOGGER
 
-#include <iostream>
-
 void rv::DebugLogger::Log(const utf16_string& message, Severity severity)
 {
-	WriteToSTD(message, severity);
+	WriteToSinks(message, severity);
 	Logger::Log(message, severity);
 }
 
-void rv::DebugLogger::WriteToSTD(const utf16_string& message, Severity severity)
+void rv::DebugLogger::Flush()
 {
-	std::lock_guard guard(mutex);
+	limiter.Report([this](const utf16_string& summary, Severity severity) { Log(summary, severity); });
+
+#	ifdef RV_ASYNC_LOGGER
+	writer.Flush();
+#	else
+	console.Flush();
+	file.Flush();
+#	endif
+}
+
+rv::Result rv::DebugLogger::OpenLogFile(const LogRotation& rotation)
+{
+	return file.Open(rotation);
+}
+
+void rv::DebugLogger::WriteToSinks(const utf16_string& message, Severity severity)
+{
+#	ifdef RV_ASYNC_LOGGER
+	writer.Write(message, severity);
+#	else
 	LogInfo info;
 	info.message = message;
 	info.severity = severity;
-	info.Format(std::wcout);
-	std::cout << '\n';
+	std::string line;
+	info.Format(line);
+
+	// without the writer thread every line is written through, so nothing is lost if the process goes down
+	console.Write(line);
+	file.Write(line);
+	console.Flush();
+	file.Flush();
+#	endif
 }
 
 #endif
@@ -160,19 +339,20 @@ rv::utf16_string rv::LogInfo::Format() const
 
 void rv::LogInfo::Format(std::wostream& ss) const
 {
+	const TimeStamp::Breakdown time = stamp.breakdown();
 	ss << L'[';
-	if (stamp.hours() < 10)
-		ss << L'0' << stamp.hours() << L':';
+	if (time.hours < 10)
+		ss << L'0' << time.hours << L':';
 	else
-		ss << stamp.hours() << L':';
-	if (stamp.minutes() < 10)
-		ss << L'0' << stamp.minutes() << L':';
+		ss << time.hours << L':';
+	if (time.minutes < 10)
+		ss << L'0' << time.minutes << L':';
 	else
-		ss << stamp.minutes() << L':';
-	if (stamp.seconds() < 10)
-		ss << L'0' << stamp.seconds() << L"]\t";
+		ss << time.minutes << L':';
+	if (time.seconds < 10)
+		ss << L'0' << time.seconds << L"]\t";
 	else
-		ss << stamp.seconds() << L"]\t";
+		ss << time.seconds << L"]\t";
 
 	switch (severity)
 	{
@@ -184,4 +364,37 @@ void rv::LogInfo::Format(std::wostream& ss) const
 	}
 
 	ss << message.c_str<wchar_t>();
+}
+
+void rv::LogInfo::Format(std::string& out) const
+{
+	const auto two_digits = [&out](long long value)
+	{
+		out += (char)('0' + value / 10 % 10);
+		out += (char)('0' + value % 10);
+	};
+
+	const TimeStamp::Breakdown time = stamp.breakdown();
+	out += '[';
+	two_digits(time.hours);
+	out += ':';
+	two_digits(time.minutes);
+	out += ':';
+	two_digits(time.seconds);
+	out += "]\t";
+
+	switch (severity)
+	{
+		case RV_SEVERITY_NULL:		out += "<NULL>     "; break;
+		case RV_SEVERITY_INFO:		out += "<INFO>     "; break;
+		case RV_SEVERITY_WARNING:	out += "<WARNING>  "; break;
+		case RV_SEVERITY_ERROR:
+		case RV_SEVERITY_ALL:		out += "<ERROR>    "; break;
+	}
+
+	// lone surrogates are replaced by U+FFFD, so the sinks only ever see valid UTF-8
+	thread_local std::u8string encoded;
+	encoded.clear();
+	encoding::append_stdstring_size(encoded, message.data(), message.character_size());
+	out.append(reinterpret_cast<const char*>(encoded.data()), encoded.size());
 }
\ No newline at end of file
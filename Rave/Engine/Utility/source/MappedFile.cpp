@@ -0,0 +1,110 @@
+#include "Engine/Utility/MappedFile.h"
+#include "Engine/Utility/Error.h"
+#include <algorithm>
+#include <cstring>
+
+rv::MappedFile::~MappedFile()
+{
+	Close();
+}
+
+rv::Result rv::MappedFile::Create(const std::filesystem::path& path)
+{
+	Close();
+
+	file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		file = nullptr;
+		return rv_check_last(false);
+	}
+	return Map(min_capacity);
+}
+
+void rv::MappedFile::Close()
+{
+	if (!file)
+		return;
+
+	Unmap();
+
+	// the mapping reserved more room than was written
+	LARGE_INTEGER end;
+	end.QuadPart = (LONGLONG)size;
+	if (SetFilePointerEx(file, end, nullptr, FILE_BEGIN))
+		SetEndOfFile(file);
+	CloseHandle(file);
+
+	file = nullptr;
+	size = 0;
+	capacity = 0;
+}
+
+rv::Result rv::MappedFile::Append(const void* data, size_t size)
+{
+	rv_result;
+
+	if (!file)
+		return failed_file;
+
+	if (this->size + size > capacity)
+	{
+		size_t grown = std::max(capacity * 2, min_capacity);
+		while (grown < this->size + size)
+			grown *= 2;
+		rv_rif(Map(grown));
+	}
+
+	std::memcpy(view + this->size, data, size);
+	this->size += size;
+	return result;
+}
+
+bool rv::MappedFile::IsOpen() const
+{
+	return file != nullptr;
+}
+
+const rv::byte* rv::MappedFile::Data() const
+{
+	return view;
+}
+
+size_t rv::MappedFile::Size() const
+{
+	return size;
+}
+
+rv::Result rv::MappedFile::Map(size_t capacity)
+{
+	// the old view stays mapped until the new one is, so a failed growth keeps everything appended so far readable
+	// a mapping larger than the file extends the file
+	void* mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, (DWORD)((u64)capacity >> 32), (DWORD)((u64)capacity & 0xFFFFFFFF), nullptr);
+	if (!mapping)
+		return rv_check_last(false);
+
+	byte* view = reinterpret_cast<byte*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, capacity));
+	if (!view)
+	{
+		const Result result = rv_check_last(false);
+		CloseHandle(mapping);
+		return result;
+	}
+
+	Unmap();
+	this->mapping = mapping;
+	this->view = view;
+	this->capacity = capacity;
+	return success;
+}
+
+void rv::MappedFile::Unmap()
+{
+	if (view)
+		UnmapViewOfFile(view);
+	if (mapping)
+		CloseHandle(mapping);
+	view = nullptr;
+	mapping = nullptr;
+	capacity = 0;
+}
\ No newline at end of file
@@ -1,36 +1,63 @@
 #include "Engine/Utility/ResultHandler.h"
+#include "Engine/Utility/Error.h"
+#include <algorithm>
+#include <bit>
+#include <iomanip>
 
 rv::ResultHandler rv::resultHandler;
 
+static std::atomic<rv::u64> next_result_queue_generation = 1;
+
 rv::ResultException::ResultException(const Result& result)
 	:
-	m_result(result)
+	m_result(result),
+	m_name(resultHandler.GetResultName(result))
 {
-	std::wostringstream ss;
-	Format(ss);
-	m_message_8 = ss.str();
-	m_message_16 = ss.str();
 }
 
 rv::ResultException::ResultException(const Result& result, const utf16_string& message)
 	:
-	m_result(result)
+	m_result(result),
+	m_name(resultHandler.GetResultName(result)),
+	m_message(message)
+{
+}
+
+rv::ResultException::ResultException(const Result& result, utf16_string&& message)
+	:
+	m_result(result),
+	m_name(resultHandler.GetResultName(result)),
+	m_message(std::move(message))
+{
+}
+
+rv::ResultException::ResultException(const ResultException& rhs)
+	:
+	std::exception(rhs),
+	m_result(rhs.m_result),
+	m_name(rhs.m_name),
+	m_message(rhs.m_message)
 {
-	std::wostringstream ss;
-	Format(ss);
-	rv::detail::str(ss, L"\n\nMessage: ", message);
-	m_message_8 = ss.str();
-	m_message_16 = ss.str();
+	// text that is still being formatted is formatted again by the copy
+	if (rhs.m_formatted.load(std::memory_order_acquire))
+	{
+		m_what_8 = rhs.m_what_8;
+		m_what_16 = rhs.m_what_16;
+		std::call_once(m_format, []() {});
+		m_formatted.store(true, std::memory_order_relaxed);
+	}
 }
 
 const char* rv::ResultException::what() const
 {
-	return m_message_8.c_str<char>();
+	Format();
+	return m_what_8.empty() ? "Result Exception occurred!" : m_what_8.c_str<char>();
 }
 
 const wchar_t* rv::ResultException::wide_what() const
 {
-	return m_message_16.c_str<wchar_t>();
+	Format();
+	return m_what_16.empty() ? L"Result Exception occurred!" : m_what_16.c_str<wchar_t>();
 }
 
 const rv::Result& rv::ResultException::result() const
@@ -38,34 +65,140 @@ const rv::Result& rv::ResultException::result() const
 	return m_result;
 }
 
-void rv::ResultException::Format(std::wostringstream& ss)
+void rv::ResultException::Format() const
+{
+	std::call_once(m_format, [this]()
+		{
+			// what is called while exceptions are being handled, so running out of memory falls back to a fixed text instead of throwing
+			try
+			{
+				std::wostringstream ss;
+				rv::detail::str(ss, L"Result Exception occurred!\n\n");
+				rv::detail::str(ss, L"Type: ", m_name ? m_name : "Unknown", L'\n');
+				rv::detail::str(ss, L"Severity: ", to_wstring(m_result.severity()));
+				if (!m_message.empty())
+					rv::detail::str(ss, L"\n\nMessage: ", m_message);
+				m_what_16 = ss.str();
+				m_what_8 = m_what_16;
+			}
+			catch (const std::bad_alloc&)
+			{
+				m_what_16 = utf16_string();
+				m_what_8 = utf8_string();
+			}
+			m_formatted.store(true, std::memory_order_release);
+		}
+	);
+}
+
+rv::ResultHandler::ResultHandler()
+	:
+	generation(next_result_queue_generation.fetch_add(1, std::memory_order_relaxed))
 {
-	const char* name = resultHandler.GetResultName(m_result);
-	if (!name)
-		name = "Unknown";
+}
 
-	rv::detail::str(ss, L"Result Exception occurred!\n\n");
-	rv::detail::str(ss, L"Type: ", name, L'\n');
-	rv::detail::str(ss, L"Severity: ", to_wstring(m_result.severity()));
+// The low bits of a result hash are ignored, so a key with the lowest bit set is never 0, which marks a free slot
+static constexpr rv::u32 result_name_key(rv::u32 hash)
+{
+	return (hash & ~0b111) | 1;
 }
 
+template<size_t N>
+class ResultNameTable
+{
+public:
+	static constexpr size_t capacity = std::bit_ceil(N * 2);
+
+	constexpr ResultNameTable(const rv::Identifier32 (&results)[N])
+	{
+		for (const rv::Identifier32& result : results)
+		{
+			const rv::u32 key = result_name_key(result.hash());
+			size_t slot = key & (capacity - 1);
+			while (keys[slot] && keys[slot] != key)
+				slot = (slot + 1) & (capacity - 1);
+			keys[slot] = key;
+			names[slot] = result.name();
+		}
+	}
+
+	constexpr const char* Find(rv::u32 hash) const
+	{
+		const rv::u32 key = result_name_key(hash);
+		for (size_t slot = key & (capacity - 1); keys[slot]; slot = (slot + 1) & (capacity - 1))
+			if (keys[slot] == key)
+				return names[slot];
+		return nullptr;
+	}
+
+private:
+	rv::u32 keys[capacity]{};
+	const char* names[capacity]{};
+};
+
+static constexpr ResultNameTable builtin_result_names({
+	rv::global_result,
+	rv::condition_result,
+	rv::assertion_result,
+	rv::file_result,
+	rv::hr_result,
+	rv::vkr_result,
+	rv::vulkan_debug_result,
+});
+
+static_assert(builtin_result_names.Find(rv::vkr_result.hash()) == rv::vkr_result.name());
+
 void rv::ResultHandler::RegisterResult(const Identifier32& result)
 {
-	std::lock_guard guard(nameMutex);
-	nameMap[result.hash() & ~0b111] = result.name();
+	if (builtin_result_names.Find(result.hash()))
+		return;
+
+	const u32 key = result_name_key(result.hash());
+	for (size_t i = 0; i < max_result_names; ++i)
+	{
+		const size_t slot = (key + i) % max_result_names;
+		u32 claimed = nameKeys[slot].load(std::memory_order_acquire);
+		if (claimed == 0 && nameKeys[slot].compare_exchange_strong(claimed, key, std::memory_order_acq_rel))
+			claimed = key;
+		if (claimed == key)
+		{
+			names[slot].store(result.name(), std::memory_order_release);
+			return;
+		}
+	}
 }
 
-const char* rv::ResultHandler::GetResultName(const Result& result)
+const char* rv::ResultHandler::GetResultName(const Result& result) const
 {
-	std::lock_guard guard(nameMutex);
-	u32 key = result.data() & ~0b111;
-	return nameMap[key];
+	if (const char* name = builtin_result_names.Find(result.hash()))
+		return name;
+
+	const u32 key = result_name_key(result.hash());
+	for (size_t i = 0; i < max_result_names; ++i)
+	{
+		const size_t slot = (key + i) % max_result_names;
+		const u32 claimed = nameKeys[slot].load(std::memory_order_acquire);
+		if (claimed == 0)
+			return nullptr;
+		// the name may not be published yet right after the key was claimed
+		if (claimed == key)
+			return names[slot].load(std::memory_order_acquire);
+	}
+	return nullptr;
 }
 
 rv::ResultQueue& rv::ResultHandler::GetThreadQueue()
 {
+	thread_local u64 cachedGeneration = 0;
+	thread_local ResultQueue* cachedQueue = nullptr;
+	if (cachedQueue && cachedGeneration == generation.load(std::memory_order_acquire))
+		return *cachedQueue;
+
+	// map nodes never move, the queue stays put until Clear renews the generation
 	std::lock_guard guard(queueMutex);
-	return queueMap[std::this_thread::get_id()];
+	cachedQueue = &queueMap[std::this_thread::get_id()];
+	cachedGeneration = generation.load(std::memory_order_relaxed);
+	return *cachedQueue;
 }
 
 std::vector<std::reference_wrapper<std::pair<const std::thread::id, rv::ResultQueue>>> rv::ResultHandler::GetQueues()
@@ -78,32 +211,101 @@ std::vector<std::reference_wrapper<std::pair<const std::thread::id, rv::ResultQu
 	return queues;
 }
 
+void rv::ResultHandler::PushResult(Result result, utf16_string&& message)
+{
+	if (Aggregating())
+		GetThreadQueue().Statistics().Add(result, std::move(message));
+	else
+		GetThreadQueue().PushResult(result, std::move(message));
+}
+
+void rv::ResultHandler::SetAggregation(bool aggregate)
+{
+	this->aggregate.store(aggregate, std::memory_order_relaxed);
+}
+
+bool rv::ResultHandler::Aggregating() const
+{
+	return aggregate.load(std::memory_order_relaxed);
+}
+
+static void write_time(std::wostream& ss, const rv::TimeStamp& stamp)
+{
+	const rv::TimeStamp::Breakdown time = stamp.breakdown();
+	const wchar_t fill = ss.fill(L'0');
+	ss << std::setw(2) << time.hours << L':' << std::setw(2) << time.minutes << L':' << std::setw(2) << time.seconds << L'.' << std::setw(3) << time.milliseconds;
+	ss.fill(fill);
+}
+
+rv::Severity rv::ResultHandler::DumpStatistics(std::wostream& ss)
+{
+	Severity maxSeverity = RV_SEVERITY_NULL;
+	for (auto& ref : GetQueues())
+	{
+		const std::thread::id thread = ref.get().first;
+		const ResultStatistics& statistics = ref.get().second.Statistics();
+		std::vector<ResultStatistic> snapshot = statistics.Snapshot();
+		if (snapshot.empty() && !statistics.Overflow())
+			continue;
+
+		std::sort(snapshot.begin(), snapshot.end(), [](const ResultStatistic& lhs, const ResultStatistic& rhs) { return lhs.count > rhs.count; });
+
+		detail::str(ss, L"Thread 0x", std::hex, thread, std::dec, L":\t", snapshot.size(), L" call sites\n");
+		for (const ResultStatistic& statistic : snapshot)
+		{
+			const char* name = GetResultName(statistic.result);
+			detail::str(ss, L"\nType:\t\t", name ? name : "Unknown", L'\n');
+			detail::str(ss, L"Severity:\t\t", to_wstring(statistic.result.severity()), L'\n');
+			if (maxSeverity < statistic.result.severity())
+				maxSeverity = statistic.result.severity();
+			detail::str(ss, L"Count:\t\t", statistic.count, L'\n');
+			detail::str(ss, L"First:\t\t");
+			write_time(ss, statistic.first);
+			detail::str(ss, L"\nLast:\t\t");
+			write_time(ss, statistic.last);
+			ss << L'\n';
+			if (!statistic.info.empty())
+				detail::str(ss, statistic.info, L'\n');
+			if (!statistic.message.empty())
+				detail::str(ss, L"Message:\n", statistic.message, L'\n');
+		}
+		if (statistics.Overflow())
+			detail::str(ss, L'\n', statistics.Overflow(), L" results from other call sites weren't recorded\n");
+		ss << L"\n\n";
+	}
+	return maxSeverity;
+}
+
 void rv::ResultHandler::Clear()
 {
+	// names are static strings, a reader racing with this at worst returns one that was just removed
+	for (size_t slot = 0; slot < max_result_names; ++slot)
 	{
-		std::lock_guard guard(nameMutex);
-		nameMap.clear();
+		names[slot].store(nullptr, std::memory_order_relaxed);
+		nameKeys[slot].store(0, std::memory_order_release);
 	}
 	{
 		std::lock_guard guard(queueMutex);
 		queueMap.clear();
+		generation.store(next_result_queue_generation.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
 	}
 }
 
-bool check(rv::Queue<rv::ResultQueue::ResultInfo>::Header* header, const rv::Flags<rv::Severity>& severity)
-{
-	return severity.contains(header->info.result.severity());
-}
-
 rv::ResultQueue::ResultQueue(ResultQueue&& rhs) noexcept
 	:
-	queue(std::move(rhs.queue))
+	sequence(rhs.sequence),
+	statistics(std::move(rhs.statistics))
 {
+	for (size_t i = 0; i < severity_count; ++i)
+		queues[i] = std::move(rhs.queues[i]);
 }
 
 rv::ResultQueue& rv::ResultQueue::operator=(ResultQueue&& rhs) noexcept
 {
-	queue = std::move(rhs.queue);
+	for (size_t i = 0; i < severity_count; ++i)
+		queues[i] = std::move(rhs.queues[i]);
+	sequence = rhs.sequence;
+	statistics = std::move(rhs.statistics);
 	return *this;
 }
 
@@ -112,12 +314,126 @@ void rv::ResultQueue::PushResult(Result result, utf16_string&& message)
 	ResultInfo r;
 	r.message = std::move(message);
 	r.result = result;
-	queue.PushEntry(std::move(r));
+	r.sequence = sequence++;
+	queues[SeverityIndex(result.severity())].PushEntry(std::move(r));
 }
 
 rv::Queue<rv::ResultQueue::ResultInfo>::Header* rv::ResultQueue::GetResult(Flags<Severity> severity)
 {
-	return queue.GetHeader(check, severity);
+	// the oldest result of the requested severities is at the front of one of their lists
+	Queue<ResultInfo>* oldest = nullptr;
+	for (size_t i = 0; i < severity_count; ++i)
+	{
+		if (!severity.contains(make_flag<Severity>((unsigned char)i)))
+			continue;
+		Queue<ResultInfo>::Header* front = queues[i].PeekHeader();
+		if (front && (!oldest || front->info.sequence < oldest->PeekHeader()->info.sequence))
+			oldest = &queues[i];
+	}
+	return oldest ? oldest->GetHeader() : nullptr;
+}
+
+size_t rv::ResultQueue::SeverityIndex(Severity severity)
+{
+	// combined severities only go to the list of their highest one
+	if (severity & RV_SEVERITY_ERROR)
+		return 2;
+	if (severity & RV_SEVERITY_WARNING)
+		return 1;
+	return 0;
+}
+
+rv::ResultStatistics& rv::ResultQueue::Statistics()
+{
+	return statistics;
+}
+
+rv::ResultStatistics::ResultStatistics(ResultStatistics&& rhs) noexcept
+{
+	std::lock_guard guard(rhs.mutex);
+	statistics = std::move(rhs.statistics);
+	overflow = rhs.overflow;
+	rhs.overflow = 0;
+}
+
+rv::ResultStatistics& rv::ResultStatistics::operator=(ResultStatistics&& rhs) noexcept
+{
+	if (this != &rhs)
+	{
+		std::scoped_lock guard(mutex, rhs.mutex);
+		statistics = std::move(rhs.statistics);
+		overflow = rhs.overflow;
+		rhs.overflow = 0;
+	}
+	return *this;
+}
+
+void rv::ResultStatistics::Add(Result result, utf16_string&& message)
+{
+	std::lock_guard guard(mutex);
+	ResultStatistic* statistic = Find(result, nullptr, 0);
+	if (statistic && statistic->count == 1)
+		statistic->message = Sample(std::move(message));
+}
+
+std::vector<rv::ResultStatistic> rv::ResultStatistics::Snapshot() const
+{
+	std::lock_guard guard(mutex);
+	std::vector<ResultStatistic> snapshot;
+	snapshot.reserve(statistics.size());
+	for (const auto& [key, statistic] : statistics)
+		snapshot.push_back(statistic);
+	return snapshot;
+}
+
+rv::u64 rv::ResultStatistics::Overflow() const
+{
+	std::lock_guard guard(mutex);
+	return overflow;
+}
+
+void rv::ResultStatistics::Clear()
+{
+	std::lock_guard guard(mutex);
+	statistics.clear();
+	overflow = 0;
+}
+
+rv::ResultStatistic* rv::ResultStatistics::Find(Result result, const char* source, u64 line)
+{
+	const Key key{ result.hash(), result.severity(), source, line };
+	auto it = statistics.find(key);
+	if (it == statistics.end())
+	{
+		if (statistics.size() >= max_sites)
+		{
+			++overflow;
+			return nullptr;
+		}
+		it = statistics.emplace(key, ResultStatistic()).first;
+		it->second.result = result;
+		it->second.source = source;
+		it->second.line = line;
+	}
+
+	ResultStatistic& statistic = it->second;
+	if (statistic.count++ == 0)
+		statistic.first.Reset();
+	statistic.last.Reset();
+	return &statistic;
+}
+
+rv::utf16_string rv::ResultStatistics::Sample(utf16_string&& text)
+{
+	const std::u16string& string = text.std_string();
+	if (string.size() <= max_sample_size)
+		return std::move(text);
+
+	// don't split a surrogate pair
+	size_t size = max_sample_size;
+	if (string[size - 1] >= 0xD800 && string[size - 1] < 0xDC00)
+		--size;
+	return std::u16string(string, 0, size);
 }
 
 rv::ResultInfo::ResultInfo(Queue<ResultQueue::ResultInfo>::Header* header)
@@ -137,8 +453,7 @@ rv::ResultInfo::ResultInfo(ResultInfo&& rhs) noexcept
 
 rv::ResultInfo::~ResultInfo()
 {
-	if (valid())
-		delete header;
+	Queue<ResultQueue::ResultInfo>::Release(header);
 }
 
 rv::ResultInfo::operator bool() const
@@ -148,8 +463,7 @@ rv::ResultInfo::operator bool() const
 
 rv::ResultInfo& rv::ResultInfo::operator=(ResultInfo&& rhs) noexcept
 {
-	if (valid())
-		delete header;
+	Queue<ResultQueue::ResultInfo>::Release(header);
 	header = rhs.header;
 	rhs.header = nullptr;
 	return *this;
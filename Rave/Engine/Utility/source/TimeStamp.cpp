@@ -1,53 +1,203 @@
 #include "Engine/Utility/TimeStamp.h"
+#include <atomic>
+#include <mutex>
+
+namespace
+{
+	/*
+		Maps steady clock ticks on local wall clock time.
+		Readers go through a sequence lock, so breaking a stamp down never blocks on the thread refreshing the calibration.
+	*/
+	class ClockCalibration
+	{
+	public:
+		struct Values
+		{
+			std::chrono::steady_clock::rep ticks;
+			std::chrono::system_clock::rep system;
+			std::chrono::seconds::rep offset;
+			// the system time range, in seconds, the offset is valid for
+			std::chrono::seconds::rep offsetBegin;
+			std::chrono::seconds::rep offsetEnd;
+		};
+
+		Values Get()
+		{
+			const std::chrono::steady_clock::rep now = std::chrono::steady_clock::now().time_since_epoch().count();
+			if (now >= expires.load(std::memory_order_relaxed))
+				Refresh(now);
+
+			Values values;
+			unsigned int begin;
+			do
+			{
+				begin = sequence.load(std::memory_order_acquire);
+				values.ticks = ticks.load(std::memory_order_relaxed);
+				values.system = system.load(std::memory_order_relaxed);
+				values.offset = offset.load(std::memory_order_relaxed);
+				values.offsetBegin = offsetBegin.load(std::memory_order_relaxed);
+				values.offsetEnd = offsetEnd.load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+			}
+			while ((begin & 1) || begin != sequence.load(std::memory_order_relaxed));
+			return values;
+		}
+
+	private:
+		void Refresh(std::chrono::steady_clock::rep now)
+		{
+			// once calibrated, readers keep using the current values while another thread refreshes them
+			std::unique_lock lock(mutex, std::defer_lock);
+			if (expires.load(std::memory_order_relaxed) == 0)
+				lock.lock();
+			else if (!lock.try_lock())
+				return;
+			if (now < expires.load(std::memory_order_relaxed))
+				return;
+
+			const auto steadyNow = std::chrono::steady_clock::now();
+			const auto systemNow = std::chrono::system_clock::now();
+			const std::chrono::sys_info zoneInfo = std::chrono::current_zone()->get_info(systemNow);
+
+			const unsigned int begin = sequence.load(std::memory_order_relaxed);
+			sequence.store(begin + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			ticks.store(steadyNow.time_since_epoch().count(), std::memory_order_relaxed);
+			system.store(systemNow.time_since_epoch().count(), std::memory_order_relaxed);
+			offset.store(zoneInfo.offset.count(), std::memory_order_relaxed);
+			offsetBegin.store(zoneInfo.begin.time_since_epoch().count(), std::memory_order_relaxed);
+			offsetEnd.store(zoneInfo.end.time_since_epoch().count(), std::memory_order_relaxed);
+			sequence.store(begin + 2, std::memory_order_release);
+
+			const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(rv::TimeStamp::calibration_period);
+			expires.store((steadyNow + period).time_since_epoch().count(), std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<unsigned int> sequence = 0;
+		std::atomic<std::chrono::steady_clock::rep> ticks = 0;
+		std::atomic<std::chrono::system_clock::rep> system = 0;
+		std::atomic<std::chrono::seconds::rep> offset = 0;
+		std::atomic<std::chrono::seconds::rep> offsetBegin = 0;
+		std::atomic<std::chrono::seconds::rep> offsetEnd = 0;
+		std::atomic<std::chrono::steady_clock::rep> expires = 0;
+		std::mutex mutex;
+	};
+
+	ClockCalibration& calibration()
+	{
+		static ClockCalibration calibration;
+		return calibration;
+	}
+
+	std::chrono::system_clock::time_point system_time(std::chrono::steady_clock::rep ticks, const ClockCalibration::Values& values)
+	{
+		const auto elapsed = std::chrono::steady_clock::duration(ticks - values.ticks);
+		return std::chrono::system_clock::time_point(std::chrono::system_clock::duration(values.system)) + std::chrono::duration_cast<std::chrono::system_clock::duration>(elapsed);
+	}
+}
+
+rv::TimeStamp::TimeStamp()
+	:
+	m_ticks(std::chrono::steady_clock::now().time_since_epoch().count()),
+	m_zone(nullptr)
+{
+}
 
 rv::TimeStamp::TimeStamp(const TimeZone& zone)
 	:
-	ymd(),
-	hms()
+	m_ticks(std::chrono::steady_clock::now().time_since_epoch().count()),
+	m_zone(zone.zone())
+{
+}
+
+rv::TimeStamp::Breakdown rv::TimeStamp::breakdown() const
 {
-	Reset(zone);
+	const auto tp = local();
+	const auto date = std::chrono::floor<std::chrono::days>(tp);
+	const std::chrono::year_month_day ymd(date);
+	const std::chrono::hh_mm_ss hms(tp - date);
+	return {
+		(int)ymd.year(),
+		(unsigned int)ymd.month(),
+		(unsigned int)ymd.day(),
+		(int)hms.hours().count(),
+		(int)hms.minutes().count(),
+		hms.seconds().count(),
+		hms.subseconds().count()
+	};
 }
+
 int rv::TimeStamp::year() const
 {
-	return (int)ymd.year();
+	return breakdown().year;
 }
 
 unsigned int rv::TimeStamp::month() const
 {
-	return (unsigned int)ymd.month();
+	return breakdown().month;
 }
 
 unsigned int rv::TimeStamp::day() const
 {
-	return (unsigned int)ymd.day();
+	return breakdown().day;
 }
 
 int rv::TimeStamp::hours() const
 {
-	return hms.hours().count();
+	return breakdown().hours;
 }
 
 int rv::TimeStamp::minutes() const
 {
-	return hms.minutes().count();
+	return breakdown().minutes;
 }
 
 long long rv::TimeStamp::seconds() const
 {
-	return hms.seconds().count();
+	return breakdown().seconds;
 }
 
 long long  rv::TimeStamp::milliseconds() const
 {
-	return hms.subseconds().count();
+	return breakdown().milliseconds;
+}
+
+std::chrono::steady_clock::time_point rv::TimeStamp::ticks() const
+{
+	return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(m_ticks));
+}
+
+std::chrono::system_clock::time_point rv::TimeStamp::time() const
+{
+	return system_time(m_ticks, calibration().Get());
+}
+
+void rv::TimeStamp::Reset()
+{
+	m_ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+	m_zone = nullptr;
 }
 
 void rv::TimeStamp::Reset(const TimeZone& zone)
 {
-	auto tp = std::chrono::zoned_time( zone.zone(), std::chrono::system_clock::now()).get_local_time();
-	auto dp = std::chrono::floor<std::chrono::days>(tp);
-	ymd = std::chrono::year_month_day(dp);
-	hms = std::chrono::hh_mm_ss(floor<std::chrono::milliseconds>(tp - dp));
+	m_ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+	m_zone = zone.zone();
+}
+
+std::chrono::local_time<std::chrono::milliseconds> rv::TimeStamp::local() const
+{
+	const ClockCalibration::Values values = calibration().Get();
+	const auto utc = std::chrono::floor<std::chrono::milliseconds>(system_time(m_ticks, values));
+	if (m_zone)
+		return m_zone->to_local(utc);
+
+	// stamps outside the cached offset's range, e.g. from before a daylight saving change, look their own offset up
+	const std::chrono::seconds::rep utcSeconds = std::chrono::floor<std::chrono::seconds>(utc).time_since_epoch().count();
+	if (utcSeconds < values.offsetBegin || utcSeconds >= values.offsetEnd)
+		return std::chrono::current_zone()->to_local(utc);
+
+	return std::chrono::local_time<std::chrono::milliseconds>(utc.time_since_epoch() + std::chrono::seconds(values.offset));
 }
 
 rv::TimeZone::TimeZone()
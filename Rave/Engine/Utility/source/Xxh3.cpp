@@ -0,0 +1,94 @@
+#include "Engine/Utility/Xxh3.h"
+
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#	define RV_XXH3_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	include <emmintrin.h>
+#	define RV_XXH3_SSE2
+#endif
+
+using namespace rv::detail;
+
+/*
+	Each accumulator gains the product of the low and high half of its lane of the keyed stripe, and the lane's neighbour's unkeyed value.
+	The accumulators stay in registers for every stripe of the call.
+*/
+void rv::detail::xxh3_accumulate_stripes(u64* acc, const u8* input, size_t stripes, size_t secretOffset)
+{
+#if defined(RV_XXH3_AVX2)
+	const u8* secret = xxh3::secret_bytes + secretOffset;
+	__m256i accumulators[2];
+	for (size_t i = 0; i < 2; ++i)
+		accumulators[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc) + i);
+
+	for (size_t stripe = 0; stripe < stripes; ++stripe, input += xxh3::stripe_size, secret += xxh3::secret_consume_rate)
+		for (size_t i = 0; i < 2; ++i)
+		{
+			const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input) + i);
+			const __m256i key = _mm256_xor_si256(data, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + i));
+			const __m256i product = _mm256_mul_epu32(key, _mm256_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+			accumulators[i] = _mm256_add_epi64(accumulators[i], _mm256_add_epi64(product, _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2))));
+		}
+
+	for (size_t i = 0; i < 2; ++i)
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(acc) + i, accumulators[i]);
+
+#elif defined(RV_XXH3_SSE2)
+	const u8* secret = xxh3::secret_bytes + secretOffset;
+	__m128i accumulators[4];
+	for (size_t i = 0; i < 4; ++i)
+		accumulators[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc) + i);
+
+	for (size_t stripe = 0; stripe < stripes; ++stripe, input += xxh3::stripe_size, secret += xxh3::secret_consume_rate)
+		for (size_t i = 0; i < 4; ++i)
+		{
+			const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input) + i);
+			const __m128i key = _mm_xor_si128(data, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i));
+			const __m128i product = _mm_mul_epu32(key, _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+			accumulators[i] = _mm_add_epi64(accumulators[i], _mm_add_epi64(product, _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2))));
+		}
+
+	for (size_t i = 0; i < 4; ++i)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(acc) + i, accumulators[i]);
+
+#else
+	const HashInput<u8> bytes = { input, stripes * xxh3::stripe_size };
+	for (size_t stripe = 0; stripe < stripes; ++stripe)
+		xxh3::accumulate_512(acc, bytes, stripe * xxh3::stripe_size, secretOffset + stripe * xxh3::secret_consume_rate);
+#endif
+}
+
+// Multiplies by a 32 bit prime as the sum of the products of both halves, SSE2 and AVX2 only multiply 32 bit lanes
+void rv::detail::xxh3_scramble_accumulators(u64* acc)
+{
+#if defined(RV_XXH3_AVX2)
+	const u8* secret = xxh3::secret_bytes + xxh3::secret_size - xxh3::stripe_size;
+	const __m256i prime = _mm256_set1_epi32((int)xxh3::prime32_1);
+	for (size_t i = 0; i < 2; ++i)
+	{
+		__m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc) + i);
+		value = _mm256_xor_si256(value, _mm256_srli_epi64(value, 47));
+		value = _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + i));
+		const __m256i low = _mm256_mul_epu32(value, prime);
+		const __m256i high = _mm256_mul_epu32(_mm256_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(acc) + i, _mm256_add_epi64(low, _mm256_slli_epi64(high, 32)));
+	}
+
+#elif defined(RV_XXH3_SSE2)
+	const u8* secret = xxh3::secret_bytes + xxh3::secret_size - xxh3::stripe_size;
+	const __m128i prime = _mm_set1_epi32((int)xxh3::prime32_1);
+	for (size_t i = 0; i < 4; ++i)
+	{
+		__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc) + i);
+		value = _mm_xor_si128(value, _mm_srli_epi64(value, 47));
+		value = _mm_xor_si128(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i));
+		const __m128i low = _mm_mul_epu32(value, prime);
+		const __m128i high = _mm_mul_epu32(_mm_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(acc) + i, _mm_add_epi64(low, _mm_slli_epi64(high, 32)));
+	}
+
+#else
+	xxh3::scramble_scalar(acc);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,385 @@
+#include "Engine/Utility/BinaryLogFormat.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+	Turns a binary log dump written by rv::BinaryLogger back into the text log the DebugLogger writes:
+	[hh:mm:ss]	<SEVERITY>  message
+
+	usage: LogDecoder [dump] [output]
+	dump defaults to Rave.binlog, the text is written to the console when no output is given.
+*/
+
+using namespace rv;
+
+struct Site
+{
+	u32 severity = 0;
+	u32 line = 0;
+	std::string file;
+	std::string format;
+};
+
+struct Clock
+{
+	i64 ticks = 0;
+	i64 system = 0;
+	i64 num = 1;
+	i64 den = 1;
+};
+
+struct Record
+{
+	i64 ticks;
+	i64 time;
+	u32 severity;
+	std::string message;
+};
+
+class Reader
+{
+public:
+	Reader(const u8* data, size_t size) : data(data), size(size) {}
+
+	template<typename T>
+	bool Read(T& value)
+	{
+		if (size - position < sizeof(T))
+			return false;
+		std::memcpy(&value, data + position, sizeof(T));
+		position += sizeof(T);
+		return true;
+	}
+
+	bool Read(const u8*& bytes, size_t count)
+	{
+		if (size - position < count)
+			return false;
+		bytes = data + position;
+		position += count;
+		return true;
+	}
+
+	bool ReadString(std::string& string)
+	{
+		u32 length;
+		const u8* bytes;
+		if (!Read(length) || !Read(bytes, length))
+			return false;
+		string.assign(reinterpret_cast<const char*>(bytes), length);
+		return true;
+	}
+
+	bool End() const { return position == size; }
+
+private:
+	const u8* data;
+	size_t size;
+	size_t position = 0;
+};
+
+// Code points that can't be encoded, including lone surrogates, are replaced by U+FFFD
+static void append_utf8(std::string& out, u32 point)
+{
+	if (point >= 0xD800 && point < 0xE000)
+		out += "\xEF\xBF\xBD";
+	else if (point < 0x80)
+		out += (char)point;
+	else if (point < 0x800)
+	{
+		out += (char)(0xC0 | (point >> 6));
+		out += (char)(0x80 | (point & 0x3F));
+	}
+	else if (point < 0x10000)
+	{
+		out += (char)(0xE0 | (point >> 12));
+		out += (char)(0x80 | ((point >> 6) & 0x3F));
+		out += (char)(0x80 | (point & 0x3F));
+	}
+	else if (point < 0x110000)
+	{
+		out += (char)(0xF0 | (point >> 18));
+		out += (char)(0x80 | ((point >> 12) & 0x3F));
+		out += (char)(0x80 | ((point >> 6) & 0x3F));
+		out += (char)(0x80 | (point & 0x3F));
+	}
+	else
+		out += "\xEF\xBF\xBD";
+}
+
+static void append_utf16(std::string& out, const u8* bytes, size_t size)
+{
+	const size_t count = size / sizeof(char16_t);
+	for (size_t i = 0; i < count; ++i)
+	{
+		char16_t unit;
+		std::memcpy(&unit, bytes + i * sizeof(char16_t), sizeof(unit));
+		u32 point = unit;
+		if (unit >= 0xD800 && unit < 0xDC00 && i + 1 < count)
+		{
+			char16_t low;
+			std::memcpy(&low, bytes + (i + 1) * sizeof(char16_t), sizeof(low));
+			if (low >= 0xDC00 && low < 0xE000)
+			{
+				point = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+				++i;
+			}
+		}
+		append_utf8(out, point);
+	}
+}
+
+static bool read_argument(Reader& reader, std::string& out)
+{
+	u8 type;
+	if (!reader.Read(type))
+		return false;
+
+	switch (type)
+	{
+		case RV_BINARY_LOG_SIGNED:
+		{
+			i64 value;
+			if (!reader.Read(value))
+				return false;
+			out = std::to_string(value);
+			return true;
+		}
+		case RV_BINARY_LOG_UNSIGNED:
+		{
+			u64 value;
+			if (!reader.Read(value))
+				return false;
+			out = std::to_string(value);
+			return true;
+		}
+		case RV_BINARY_LOG_FLOAT:
+		{
+			double value;
+			if (!reader.Read(value))
+				return false;
+			// same precision as the string streams rv::str16 formats with
+			std::ostringstream ss;
+			ss << value;
+			out = ss.str();
+			return true;
+		}
+		case RV_BINARY_LOG_BOOL:
+		{
+			u8 value;
+			if (!reader.Read(value))
+				return false;
+			out = value ? "true" : "false";
+			return true;
+		}
+		case RV_BINARY_LOG_CHAR:
+		{
+			u64 value;
+			if (!reader.Read(value))
+				return false;
+			out.clear();
+			append_utf8(out, (u32)std::min<u64>(value, 0xFFFFFFFF));
+			return true;
+		}
+		case RV_BINARY_LOG_UTF8:
+		case RV_BINARY_LOG_UTF16:
+		case RV_BINARY_LOG_UTF32:
+		{
+			u32 size;
+			const u8* bytes;
+			if (!reader.Read(size) || !reader.Read(bytes, size))
+				return false;
+			out.clear();
+			if (type == RV_BINARY_LOG_UTF8)
+				out.assign(reinterpret_cast<const char*>(bytes), size);
+			else if (type == RV_BINARY_LOG_UTF16)
+				append_utf16(out, bytes, size);
+			else
+				for (size_t i = 0; i + sizeof(u32) <= size; i += sizeof(u32))
+				{
+					u32 point;
+					std::memcpy(&point, bytes + i, sizeof(point));
+					append_utf8(out, point);
+				}
+			return true;
+		}
+		default:
+			return false;
+	}
+}
+
+// Replaces every {} in the format with the next argument, arguments without a placeholder are appended
+static std::string format_message(const std::string& format, const std::vector<std::string>& arguments)
+{
+	std::string message;
+	size_t argument = 0;
+	for (size_t i = 0; i < format.size(); ++i)
+	{
+		if (format[i] == '{' && i + 1 < format.size() && format[i + 1] == '}' && argument < arguments.size())
+		{
+			message += arguments[argument++];
+			++i;
+		}
+		else
+			message += format[i];
+	}
+	for (; argument < arguments.size(); ++argument)
+		message += arguments[argument];
+	return message;
+}
+
+static bool read_records(Reader& reader, const Clock& clock, const std::unordered_map<u32, Site>& sites, std::vector<Record>& records)
+{
+	u64 thread;
+	if (!reader.Read(thread))
+		return false;
+
+	std::vector<std::string> arguments;
+	while (!reader.End())
+	{
+		u32 siteId;
+		i64 ticks;
+		u8 count;
+		if (!reader.Read(siteId) || !reader.Read(ticks) || !reader.Read(count))
+			return false;
+
+		arguments.resize(count);
+		for (std::string& argument : arguments)
+			if (!read_argument(reader, argument))
+				return false;
+
+		auto site = sites.find(siteId);
+		if (site == sites.end())
+			return false;
+
+		const long double seconds = (long double)(ticks - clock.ticks) * clock.num / clock.den;
+		records.push_back({ ticks, clock.system + (i64)(seconds * 1000000000.0L), site->second.severity, format_message(site->second.format, arguments) });
+	}
+	return true;
+}
+
+static const char* severity_tag(u32 severity)
+{
+	// matches rv::LogInfo::Format
+	switch (severity)
+	{
+		case 0:		return "<NULL>     ";
+		case 1:		return "<INFO>     ";
+		case 2:		return "<WARNING>  ";
+		default:	return "<ERROR>    ";
+	}
+}
+
+static void write_record(std::ostream& out, const Record& record)
+{
+	auto time = std::chrono::zoned_time(std::chrono::current_zone(), std::chrono::sys_time<std::chrono::nanoseconds>(std::chrono::nanoseconds(record.time))).get_local_time();
+	auto hms = std::chrono::hh_mm_ss(std::chrono::floor<std::chrono::seconds>(time - std::chrono::floor<std::chrono::days>(time)));
+
+	const auto two_digits = [&out](long long value) { if (value < 10) out << '0'; out << value; };
+	out << '[';
+	two_digits(hms.hours().count());
+	out << ':';
+	two_digits(hms.minutes().count());
+	out << ':';
+	two_digits(hms.seconds().count());
+	out << "]\t" << severity_tag(record.severity) << record.message << '\n';
+}
+
+int main(int argc, char** argv)
+{
+	const char* path = argc > 1 ? argv[1] : "Rave.binlog";
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "Unable to open \"" << path << "\"\n";
+		return EXIT_FAILURE;
+	}
+	const std::vector<u8> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	Reader reader(data.data(), data.size());
+	u32 magic, version;
+	if (!reader.Read(magic) || !reader.Read(version) || magic != binary_log_magic || version != binary_log_version)
+	{
+		std::cerr << "\"" << path << "\" is not a binary log of a supported version\n";
+		return EXIT_FAILURE;
+	}
+
+	Clock clock;
+	std::unordered_map<u32, Site> sites;
+	std::vector<Record> records;
+	u64 dropped = 0;
+	bool corrupt = false;
+	while (!reader.End() && !corrupt)
+	{
+		u8 type;
+		u32 size;
+		const u8* payload;
+		if (!reader.Read(type) || !reader.Read(size) || !reader.Read(payload, size))
+		{
+			corrupt = true;
+			break;
+		}
+
+		Reader block(payload, size);
+		switch (type)
+		{
+			case RV_BINARY_LOG_CLOCK:
+				corrupt = !block.Read(clock.ticks) || !block.Read(clock.system) || !block.Read(clock.num) || !block.Read(clock.den) || clock.den == 0;
+				break;
+			case RV_BINARY_LOG_SITE:
+			{
+				u32 id;
+				Site site;
+				corrupt = !block.Read(id) || !block.Read(site.severity) || !block.Read(site.line) || !block.ReadString(site.file) || !block.ReadString(site.format);
+				if (!corrupt)
+					sites[id] = std::move(site);
+				break;
+			}
+			case RV_BINARY_LOG_RECORDS:
+				corrupt = !read_records(block, clock, sites, records);
+				break;
+			case RV_BINARY_LOG_DROPPED:
+			{
+				u64 thread, count;
+				corrupt = !block.Read(thread) || !block.Read(count);
+				if (!corrupt)
+					dropped += count;
+				break;
+			}
+			default:
+				// unknown blocks are skipped, so older decoders can read dumps with additional information
+				break;
+		}
+	}
+	if (corrupt)
+		std::cerr << "\"" << path << "\" is corrupt, only the records before the damaged block are decoded\n";
+	if (dropped)
+		std::cerr << dropped << " records were dropped because the logging threads' buffers were full\n";
+
+	// every thread's records are ordered, but threads are dumped one after the other
+	std::stable_sort(records.begin(), records.end(), [](const Record& lhs, const Record& rhs) { return lhs.ticks < rhs.ticks; });
+
+	std::ofstream output;
+	if (argc > 2)
+	{
+		output.open(argv[2], std::ios::binary);
+		if (!output)
+		{
+			std::cerr << "Unable to open \"" << argv[2] << "\"\n";
+			return EXIT_FAILURE;
+		}
+	}
+	std::ostream& out = argc > 2 ? output : std::cout;
+	for (const Record& record : records)
+		write_record(out, record);
+
+	return corrupt ? EXIT_FAILURE : EXIT_SUCCESS;
+}
\ No newline at end of file